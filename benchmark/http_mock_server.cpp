@@ -0,0 +1,152 @@
+// Local HTTP(S) server the benchmarks run against, so that numbers do not depend on a public service.
+//
+// Every GET, HEAD, POST, PUT, PATCH and DELETE is answered with --payload bytes after --latency milliseconds; a
+// --error-rate fraction of requests is answered with a 503 instead. Like httpbin, /status/<code> answers with that
+// status, /retry-after/<seconds> with a 503 asking to retry after that many seconds, /flaky/<name> with a 503 the
+// first time a name is asked for and normally after that, and /delay/<seconds> waits that much longer before
+// answering, which is what the tests in test/ rely on. Runs until it is killed.
+//
+//   http_mock_server [--port 8089] [--latency 0] [--payload 1024] [--error-rate 0] [--threads 64]
+//                    [--cert server.pem --key server.key]
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#include "httplib.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace duckdb_httplib_openssl;
+
+struct MockServerOptions {
+    int port = 8089;
+    int latency_ms = 0;
+    size_t payload = 1024;
+    double error_rate = 0;
+    size_t threads = 64;
+    std::string cert;
+    std::string key;
+};
+
+static void Usage() {
+    fprintf(stderr, "usage: http_mock_server [--port N] [--latency MS] [--payload BYTES] [--error-rate FRACTION] "
+                    "[--threads N] [--cert FILE --key FILE]\n");
+    exit(1);
+}
+
+static MockServerOptions ParseOptions(int argc, char **argv) {
+    MockServerOptions options;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            Usage();
+        }
+        std::string name = argv[i];
+        const char *value = argv[++i];
+        if (name == "--port") {
+            options.port = atoi(value);
+        } else if (name == "--latency") {
+            options.latency_ms = atoi(value);
+        } else if (name == "--payload") {
+            options.payload = strtoull(value, nullptr, 10);
+        } else if (name == "--error-rate") {
+            options.error_rate = atof(value);
+        } else if (name == "--threads") {
+            options.threads = strtoull(value, nullptr, 10);
+        } else if (name == "--cert") {
+            options.cert = value;
+        } else if (name == "--key") {
+            options.key = value;
+        } else {
+            Usage();
+        }
+    }
+    if (options.threads == 0 || options.cert.empty() != options.key.empty()) {
+        Usage();
+    }
+    return options;
+}
+
+int main(int argc, char **argv) {
+    auto options = ParseOptions(argc, argv);
+
+    std::unique_ptr<Server> server;
+    if (options.cert.empty()) {
+        server.reset(new Server());
+    } else {
+        server.reset(new SSLServer(options.cert.c_str(), options.key.c_str()));
+    }
+    if (!server->is_valid()) {
+        fprintf(stderr, "http_mock_server: could not set up the server (certificate or key invalid?)\n");
+        return 1;
+    }
+
+    const std::string payload(options.payload, 'x');
+    std::mutex flaky_lock;
+    std::set<std::string> flaky_failed;
+    auto handler = [&options, &payload, &flaky_lock, &flaky_failed](const Request &req, Response &res) {
+        // One generator per server thread, they are not shared
+        thread_local std::mt19937 random(std::random_device {}());
+        if (options.latency_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.latency_ms));
+        }
+        if (options.error_rate > 0 && std::uniform_real_distribution<double>(0, 1)(random) < options.error_rate) {
+            res.status = 503;
+            res.set_content("unavailable", "text/plain");
+            return;
+        }
+        if (req.matches.size() > 1 && req.path.compare(0, 8, "/status/") == 0) {
+            res.status = atoi(req.matches[1].str().c_str());
+            res.set_content(std::to_string(res.status), "text/plain");
+            return;
+        }
+        if (req.matches.size() > 1 && req.path.compare(0, 13, "/retry-after/") == 0) {
+            res.status = 503;
+            res.set_header("Retry-After", req.matches[1].str());
+            res.set_content("unavailable", "text/plain");
+            return;
+        }
+        if (req.matches.size() > 1 && req.path.compare(0, 7, "/flaky/") == 0) {
+            std::lock_guard<std::mutex> guard(flaky_lock);
+            if (flaky_failed.insert(req.matches[1].str()).second) {
+                res.status = 503;
+                res.set_content("unavailable", "text/plain");
+                return;
+            }
+        }
+        if (req.matches.size() > 1 && req.path.compare(0, 7, "/delay/") == 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(atof(req.matches[1].str().c_str())));
+        }
+        res.set_header("X-Request-Body-Length", std::to_string(req.body.size()));
+        res.set_header("X-Request-Method", req.method);
+        res.set_content(payload, "application/octet-stream");
+    };
+    // Handlers are matched in the order they are registered, the catch-all comes last. httplib answers HEAD with
+    // the GET handler and leaves the body out
+    for (auto pattern : {R"(/status/(\d+))", R"(/retry-after/(\d+))", R"(/flaky/(\w+))", R"(/delay/([0-9.]+))",
+                          R"(/.*)"}) {
+        server->Get(pattern, handler);
+        server->Post(pattern, handler);
+        server->Put(pattern, handler);
+        server->Patch(pattern, handler);
+        server->Delete(pattern, handler);
+    }
+
+    auto threads = options.threads;
+    server->new_task_queue = [threads]() { return new ThreadPool(threads); };
+
+    fprintf(stderr, "http_mock_server: listening on %s://127.0.0.1:%d\n", options.cert.empty() ? "http" : "https",
+            options.port);
+    if (!server->listen("127.0.0.1", options.port)) {
+        fprintf(stderr, "http_mock_server: could not listen on port %d\n", options.port);
+        return 1;
+    }
+    return 0;
+}
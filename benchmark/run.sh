@@ -0,0 +1,114 @@
+#!/usr/bin/env bash
+# Drives http_get/http_post against the local mock server and reports requests/sec, p50/p99 latency, CPU time
+# per request and peak memory of the DuckDB process.
+#
+#   BUILD_BENCHMARK=1 make release
+#   benchmark/run.sh [rows ...]                    (default: 10000 100000)
+#
+# Environment: BUILD (build/release), PORT (8089), LATENCY (ms, 0), PAYLOAD (bytes, 1024), ERROR_RATE (0),
+# TLS (0, 1 serves HTTPS with a throwaway self-signed certificate), SETTINGS (extra SQL run before every query,
+# e.g. 'SET http_client_max_concurrency = 64;')
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+BUILD=${BUILD:-build/release}
+PORT=${PORT:-8089}
+LATENCY=${LATENCY:-0}
+PAYLOAD=${PAYLOAD:-1024}
+ERROR_RATE=${ERROR_RATE:-0}
+TLS=${TLS:-0}
+SETTINGS=${SETTINGS:-}
+ROWS=("$@")
+if [ ${#ROWS[@]} -eq 0 ]; then
+    ROWS=(10000 100000)
+fi
+
+DUCKDB="$BUILD/duckdb"
+SERVER="$BUILD/extension/http_client/http_mock_server"
+for binary in "$DUCKDB" "$SERVER"; do
+    if [ ! -x "$binary" ]; then
+        echo "$binary not found, build with: BUILD_BENCHMARK=1 make release" >&2
+        exit 1
+    fi
+done
+if ! /usr/bin/time -f '' true 2>/dev/null; then
+    echo "GNU time (/usr/bin/time) is required" >&2
+    exit 1
+fi
+
+WORK=$(mktemp -d)
+SERVER_PID=
+cleanup() {
+    if [ -n "$SERVER_PID" ]; then
+        kill "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+    fi
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+SERVER_ARGS=(--port "$PORT" --latency "$LATENCY" --payload "$PAYLOAD" --error-rate "$ERROR_RATE")
+SCHEME=http
+if [ "$TLS" = 1 ]; then
+    openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj /CN=127.0.0.1 \
+        -addext subjectAltName=IP:127.0.0.1 -keyout "$WORK/server.key" -out "$WORK/server.pem" 2>/dev/null
+    SERVER_ARGS+=(--cert "$WORK/server.pem" --key "$WORK/server.key")
+    # The client verifies the server against OpenSSL's default store, which honors SSL_CERT_FILE
+    export SSL_CERT_FILE="$WORK/server.pem"
+    SCHEME=https
+fi
+"$SERVER" "${SERVER_ARGS[@]}" 2>"$WORK/server.log" &
+SERVER_PID=$!
+URL="$SCHEME://127.0.0.1:$PORT"
+for _ in $(seq 50); do
+    if grep -q listening "$WORK/server.log"; then
+        break
+    fi
+    sleep 0.1
+done
+sleep 0.2
+if ! kill -0 "$SERVER_PID" 2>/dev/null; then
+    cat "$WORK/server.log" >&2
+    exit 1
+fi
+
+echo "server: $URL latency=${LATENCY}ms payload=${PAYLOAD}B error_rate=$ERROR_RATE"
+printf '%-10s %9s %9s %11s %9s %9s %12s %10s\n' function rows ok req/s p50_ms p99_ms cpu_us/req peak_mb
+
+run() {
+    local function=$1 rows=$2 call
+    if [ "$function" = http_get ]; then
+        call="http_get_ex('$URL/get?i=' || i)"
+    else
+        call="http_post_ex('$URL/post?i=' || i, '', '{\"i\": ' || i || '}')"
+    fi
+    # Retries would count against throughput, 503s are part of the load being measured
+    cat >"$WORK/query.sql" <<SQL
+.mode csv
+.headers off
+SET http_client_max_retries = 0;
+SET http_client_deduplicate = false;
+SET http_client_cache_size = 0;
+$SETTINGS
+SELECT count(*) FROM http_client_stats(reset := true) WHERE false;
+SELECT count(*) FILTER (WHERE ($call).status = 200) FROM range($rows) t(i);
+SELECT coalesce(max(latency_p50_ms), 0), coalesce(max(latency_p99_ms), 0) FROM http_client_stats() WHERE host = '$URL';
+SQL
+    /usr/bin/time -f '%e %U %S %M' -o "$WORK/time" "$DUCKDB" -unsigned <"$WORK/query.sql" >"$WORK/out"
+    local ok latency elapsed user sys rss
+    ok=$(sed -n 2p "$WORK/out")
+    latency=$(sed -n 3p "$WORK/out")
+    read -r elapsed user sys rss <"$WORK/time"
+    awk -v f="$function" -v rows="$rows" -v ok="$ok" -v lat="$latency" -v e="$elapsed" -v u="$user" -v s="$sys" \
+        -v rss="$rss" 'BEGIN {
+            split(lat, l, ",");
+            if (e <= 0) e = 0.01;
+            printf "%-10s %9d %9d %11.0f %9.1f %9.1f %12.1f %10.1f\n", f, rows, ok, rows / e, l[1], l[2],
+                   (u + s) * 1e6 / rows, rss / 1024
+        }'
+}
+
+for rows in "${ROWS[@]}"; do
+    run http_get "$rows"
+    run http_post "$rows"
+done
@@ -0,0 +1,284 @@
+#include "duckdb.hpp"
+#include "duckdb/function/aggregate_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+#include "http_query_state.hpp"
+#include "http_request.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace duckdb {
+
+//! The context of the query, aggregate callbacks have no ClientContext of their own. Settings are looked up when the
+//! query runs, a prepared statement is bound once but may run after its settings changed.
+struct HttpPostBatchBindData : public FunctionData {
+    weak_ptr<ClientContext> context;
+
+    unique_ptr<FunctionData> Copy() const override {
+        auto result = make_uniq<HttpPostBatchBindData>();
+        result->context = context;
+        return std::move(result);
+    }
+    bool Equals(const FunctionData &other) const override {
+        // Two http_post_batch calls of a query each send their own rows
+        return false;
+    }
+};
+
+//! Rows collected for the next request. The url and headers are those of its first row.
+struct HttpPostBatch {
+    std::string url;
+    duckdb_httplib_openssl::Headers headers;
+    //! Rows followed by a newline (NDJSON) or separated by commas (JSON array, the brackets are added on sending)
+    std::string body;
+    idx_t rows = 0;
+};
+
+struct HttpPostBatchState {
+    HttpPostBatch *batch;
+    int64_t requests;
+    int64_t rows;
+    int64_t bytes;
+};
+
+//! Settings and client state of the running query
+struct HttpPostBatchQuery {
+    HttpClientSettings settings;
+    shared_ptr<HttpClientState> client_state;
+};
+
+static HttpPostBatchQuery GetBatchQuery(AggregateInputData &aggr_input_data) {
+    auto &bind_data = aggr_input_data.bind_data->Cast<HttpPostBatchBindData>();
+    auto context = bind_data.context.lock();
+    if (!context) {
+        throw std::runtime_error("http_post_batch: the connection running the query was closed");
+    }
+    HttpPostBatchQuery query;
+    query.settings = HttpQueryState::Get(*context)->Settings(*context);
+    query.client_state = HttpClientState::Get(*context);
+    return query;
+}
+
+static bool IsJsonArrayBatch(const HttpClientSettings &settings) {
+    return settings.batch_format == "json";
+}
+
+// Send the rows collected so far as one POST, any 2xx status counts as success
+static void SendBatch(HttpPostBatchState &state, const HttpPostBatchQuery &query) {
+    auto &batch = *state.batch;
+    if (batch.rows == 0) {
+        return;
+    }
+    auto &settings = query.settings;
+    if (settings.interrupted && *settings.interrupted) {
+        throw InterruptException();
+    }
+
+    HttpRequest request;
+    request.method = "POST";
+    request.url = std::move(batch.url);
+    request.headers = std::move(batch.headers);
+    if (IsJsonArrayBatch(settings)) {
+        request.body.reserve(batch.body.size() + 2);
+        request.body += '[';
+        request.body += batch.body;
+        request.body += ']';
+    } else {
+        request.body = std::move(batch.body);
+        request.content_type = "application/x-ndjson";
+    }
+    HttpUrlResolver(settings, &query.client_state->metrics).Resolve(request);
+    auto response = PerformHttpRequest(*query.client_state, settings, request);
+    if (settings.interrupted && *settings.interrupted) {
+        throw InterruptException();
+    }
+    if (!response.received) {
+        throw std::runtime_error(response.error);
+    }
+    if (response.status < 200 || response.status >= 300) {
+        throw std::runtime_error("HTTP POST error: " + std::to_string(response.status) + " - " + response.reason);
+    }
+
+    state.requests++;
+    state.rows += batch.rows;
+    state.bytes += request.body.size();
+    batch.url.clear();
+    batch.headers.clear();
+    batch.body.clear();
+    batch.rows = 0;
+}
+
+struct HttpPostBatchOperation {
+    template <class STATE>
+    static void Initialize(STATE &state) {
+        state.batch = nullptr;
+        state.requests = 0;
+        state.rows = 0;
+        state.bytes = 0;
+    }
+
+    template <class STATE, class OP>
+    static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+        target.requests += source.requests;
+        target.rows += source.rows;
+        target.bytes += source.bytes;
+        if (!source.batch || source.batch->rows == 0) {
+            return;
+        }
+        if (!target.batch) {
+            target.batch = new HttpPostBatch(std::move(*source.batch));
+            source.batch->rows = 0;
+            return;
+        }
+
+        auto query = GetBatchQuery(aggr_input_data);
+        auto &settings = query.settings;
+        auto &from = *source.batch;
+        auto &into = *target.batch;
+        if (into.rows > 0 && (into.url != from.url || into.rows + from.rows > settings.batch_rows ||
+                              into.body.size() + from.body.size() + 1 > settings.batch_size)) {
+            SendBatch(target, query);
+        }
+        if (into.rows == 0) {
+            into = std::move(from);
+        } else {
+            if (IsJsonArrayBatch(settings)) {
+                into.body += ',';
+            }
+            into.body += from.body;
+            into.rows += from.rows;
+        }
+        from.rows = 0;
+    }
+
+    template <class STATE>
+    static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+        // Rows not sent yet are dropped, that only happens when the query failed
+        delete state.batch;
+        state.batch = nullptr;
+    }
+};
+
+static unique_ptr<FunctionData> HttpPostBatchBind(ClientContext &context, AggregateFunction &function,
+                                                  vector<unique_ptr<Expression>> &arguments) {
+    auto result = make_uniq<HttpPostBatchBindData>();
+    result->context = context.shared_from_this();
+    return std::move(result);
+}
+
+static void HttpPostBatchUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                Vector &state_vector, idx_t count) {
+    auto query = GetBatchQuery(aggr_input_data);
+    auto &settings = query.settings;
+    auto json_array = IsJsonArrayBatch(settings);
+
+    UnifiedVectorFormat url_format;
+    UnifiedVectorFormat headers_format;
+    UnifiedVectorFormat body_format;
+    UnifiedVectorFormat state_format;
+    inputs[0].ToUnifiedFormat(count, url_format);
+    inputs[1].ToUnifiedFormat(count, headers_format);
+    inputs[2].ToUnifiedFormat(count, body_format);
+    state_vector.ToUnifiedFormat(count, state_format);
+    auto urls = UnifiedVectorFormat::GetData<string_t>(url_format);
+    auto bodies = UnifiedVectorFormat::GetData<string_t>(body_format);
+    auto states = UnifiedVectorFormat::GetData<HttpPostBatchState *>(state_format);
+
+    for (idx_t row = 0; row < count; row++) {
+        auto url_index = url_format.sel->get_index(row);
+        auto body_index = body_format.sel->get_index(row);
+        if (!url_format.validity.RowIsValid(url_index) || !body_format.validity.RowIsValid(body_index)) {
+            continue;
+        }
+        auto &state = *states[state_format.sel->get_index(row)];
+        if (!state.batch) {
+            state.batch = new HttpPostBatch();
+        }
+        auto &batch = *state.batch;
+        auto &url = urls[url_index];
+        auto &body = bodies[body_index];
+
+        // A row for another URL, or one that would push the batch over its size, starts a new batch
+        if (batch.rows > 0 && (batch.url.size() != url.GetSize() ||
+                               memcmp(batch.url.data(), url.GetData(), url.GetSize()) != 0 ||
+                               batch.body.size() + body.GetSize() + 1 > settings.batch_size)) {
+            SendBatch(state, query);
+        }
+        if (batch.rows == 0) {
+            batch.url = url.GetString();
+            auto headers_index = headers_format.sel->get_index(row);
+            if (headers_format.validity.RowIsValid(headers_index)) {
+                batch.headers = HttpHeadersFromValue(inputs[1].GetValue(row));
+            }
+        } else if (json_array) {
+            batch.body += ',';
+        }
+        batch.body.append(body.GetData(), body.GetSize());
+        if (!json_array) {
+            batch.body += '\n';
+        }
+        batch.rows++;
+        if (batch.rows >= settings.batch_rows) {
+            SendBatch(state, query);
+        }
+    }
+}
+
+static LogicalType HttpPostBatchResultType() {
+    child_list_t<LogicalType> children;
+    children.emplace_back("requests", LogicalType::BIGINT);
+    children.emplace_back("rows", LogicalType::BIGINT);
+    children.emplace_back("bytes", LogicalType::BIGINT);
+    return LogicalType::STRUCT(std::move(children));
+}
+
+// Send what is left of every group's batch and report how much was posted
+static void HttpPostBatchFinalize(Vector &state_vector, AggregateInputData &aggr_input_data, Vector &result,
+                                  idx_t count, idx_t offset) {
+    auto query = GetBatchQuery(aggr_input_data);
+    UnifiedVectorFormat state_format;
+    state_vector.ToUnifiedFormat(count, state_format);
+    auto states = UnifiedVectorFormat::GetData<HttpPostBatchState *>(state_format);
+
+    if (state_vector.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+        count = 1;
+        offset = 0;
+    }
+    auto &children = StructVector::GetEntries(result);
+    auto requests = FlatVector::GetData<int64_t>(*children[0]);
+    auto rows = FlatVector::GetData<int64_t>(*children[1]);
+    auto bytes = FlatVector::GetData<int64_t>(*children[2]);
+    for (idx_t i = 0; i < count; i++) {
+        auto &state = *states[state_format.sel->get_index(i)];
+        if (state.batch) {
+            SendBatch(state, query);
+        }
+        requests[i + offset] = state.requests;
+        rows[i + offset] = state.rows;
+        bytes[i + offset] = state.bytes;
+    }
+}
+
+void HTTPFunctions::RegisterHTTPBatchFunction(DatabaseInstance &instance) {
+    // Headers are given either as "Key: Value" lines or as a MAP(VARCHAR, VARCHAR)
+    vector<LogicalType> header_types {LogicalType::VARCHAR, HttpHeadersType()};
+
+    AggregateFunctionSet http_post_batch("http_post_batch");
+    for (auto &headers : header_types) {
+        http_post_batch.AddFunction(AggregateFunction(
+            {LogicalType::VARCHAR, headers, LogicalType::VARCHAR}, HttpPostBatchResultType(),
+            AggregateFunction::StateSize<HttpPostBatchState>,
+            AggregateFunction::StateInitialize<HttpPostBatchState, HttpPostBatchOperation>, HttpPostBatchUpdate,
+            AggregateFunction::StateCombine<HttpPostBatchState, HttpPostBatchOperation>, HttpPostBatchFinalize,
+            FunctionNullHandling::SPECIAL_HANDLING, nullptr, HttpPostBatchBind,
+            AggregateFunction::StateDestroy<HttpPostBatchState, HttpPostBatchOperation>));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_post_batch);
+}
+
+} // namespace duckdb
@@ -0,0 +1,63 @@
+#include "http_buffer_pool.hpp"
+
+namespace duckdb {
+
+constexpr idx_t HttpBufferPool::MIN_CLASS_SIZE;
+constexpr idx_t HttpBufferPool::CLASS_COUNT;
+
+std::string HttpBufferPool::Take(idx_t size) {
+    idx_t size_class = 0;
+    while (size_class < CLASS_COUNT && ClassSize(size_class) < size) {
+        size_class++;
+    }
+    std::string buffer;
+    if (size_class == CLASS_COUNT) {
+        // Too large to be worth keeping around
+        buffer.reserve(size);
+        return buffer;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &buffers = free_buffers[size_class];
+        if (!buffers.empty()) {
+            buffer = std::move(buffers.back());
+            buffers.pop_back();
+            pooled_bytes -= buffer.capacity();
+            return buffer;
+        }
+    }
+    buffer.reserve(ClassSize(size_class));
+    return buffer;
+}
+
+void HttpBufferPool::Give(std::string &&buffer, idx_t max_bytes) {
+    auto capacity = buffer.capacity();
+    if (capacity < MIN_CLASS_SIZE || capacity >= ClassSize(CLASS_COUNT)) {
+        return;
+    }
+    // The largest class the buffer can serve in full
+    idx_t size_class = 0;
+    while (size_class + 1 < CLASS_COUNT && ClassSize(size_class + 1) <= capacity) {
+        size_class++;
+    }
+    buffer.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    if (pooled_bytes + capacity > max_bytes) {
+        return;
+    }
+    pooled_bytes += capacity;
+    free_buffers[size_class].push_back(std::move(buffer));
+}
+
+void HttpBufferPool::Shrink(idx_t max_bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    for (idx_t size_class = CLASS_COUNT; size_class > 0 && pooled_bytes > max_bytes; size_class--) {
+        auto &buffers = free_buffers[size_class - 1];
+        while (!buffers.empty() && pooled_bytes > max_bytes) {
+            pooled_bytes -= buffers.back().capacity();
+            buffers.pop_back();
+        }
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,56 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+
+namespace duckdb {
+
+struct HttpCacheStatsState : public GlobalTableFunctionState {
+    bool finished = false;
+};
+
+static unique_ptr<FunctionData> HttpCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    names = {"hits",      "misses",      "revalidations", "evictions",      "entries",
+             "size_bytes", "disk_hits", "disk_misses",   "disk_entries", "disk_size_bytes"};
+    return_types = vector<LogicalType>(names.size(), LogicalType::UBIGINT);
+    return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> HttpCacheStatsInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+    return make_uniq<HttpCacheStatsState>();
+}
+
+static void HttpCacheStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpCacheStatsState>();
+    if (state.finished) {
+        return;
+    }
+    state.finished = true;
+
+    auto client_state = HttpClientState::Get(context);
+    auto stats = client_state->response_cache.GetStats();
+    auto disk_stats = client_state->disk_cache.GetStats();
+    output.SetValue(0, 0, Value::UBIGINT(stats.hits));
+    output.SetValue(1, 0, Value::UBIGINT(stats.misses));
+    output.SetValue(2, 0, Value::UBIGINT(stats.revalidations));
+    output.SetValue(3, 0, Value::UBIGINT(stats.evictions));
+    output.SetValue(4, 0, Value::UBIGINT(stats.entries));
+    output.SetValue(5, 0, Value::UBIGINT(stats.size));
+    output.SetValue(6, 0, Value::UBIGINT(disk_stats.hits));
+    output.SetValue(7, 0, Value::UBIGINT(disk_stats.misses));
+    output.SetValue(8, 0, Value::UBIGINT(disk_stats.entries));
+    output.SetValue(9, 0, Value::UBIGINT(disk_stats.size));
+    output.SetCardinality(1);
+}
+
+void HTTPFunctions::RegisterHTTPCacheFunctions(DatabaseInstance &instance) {
+    TableFunction http_client_cache_stats("http_client_cache_stats", {}, HttpCacheStatsFunction, HttpCacheStatsBind,
+                                          HttpCacheStatsInit);
+    ExtensionUtil::RegisterFunction(instance, http_client_cache_stats);
+}
+
+} // namespace duckdb
@@ -4,180 +4,539 @@
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/main/extension_util.hpp"
 #include "duckdb/common/atomic.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/exception/http_exception.hpp"
 #include <duckdb/parser/parsed_data/create_scalar_function_info.hpp>
 
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include "httplib.hpp"
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_executor.hpp"
+#include "http_functions.hpp"
+#include "http_query_state.hpp"
+#include "http_request.hpp"
 
+#include <map>
 #include <string>
-#include <sstream>
+#include <unordered_map>
 
 namespace duckdb {
 
-// Helper function to parse URL and setup client
-static std::pair<duckdb_httplib_openssl::Client, std::string> SetupHttpClient(const std::string &url) {
-    std::string scheme, domain, path;
-    size_t pos = url.find("://");
-    std::string mod_url = url;
-    if (pos != std::string::npos) {
-        scheme = mod_url.substr(0, pos);
-        mod_url.erase(0, pos + 3);
-    }
-
-    pos = mod_url.find("/");
-    if (pos != std::string::npos) {
-        domain = mod_url.substr(0, pos);
-        path = mod_url.substr(pos);
-    } else {
-        domain = mod_url;
-        path = "/";
-    }
-
-    // Create client and set a reasonable timeout (e.g., 10 seconds)
-    duckdb_httplib_openssl::Client client(domain.c_str());
-    client.set_read_timeout(10, 0);  // 10 seconds
-    client.set_follow_location(true); // Follow redirects
-
-    return std::make_pair(std::move(client), path);
-}
-
-static void HandleHttpError(const duckdb_httplib_openssl::Result &res, const std::string &request_type) {
-    std::string err_message = "HTTP " + request_type + " request failed. ";
-
-    switch (res.error()) {
-        case duckdb_httplib_openssl::Error::Connection:
-            err_message += "Connection error.";
-            break;
-        case duckdb_httplib_openssl::Error::BindIPAddress:
-            err_message += "Failed to bind IP address.";
-            break;
-        case duckdb_httplib_openssl::Error::Read:
-            err_message += "Error reading response.";
-            break;
-        case duckdb_httplib_openssl::Error::Write:
-            err_message += "Error writing request.";
-            break;
-        case duckdb_httplib_openssl::Error::ExceedRedirectCount:
-            err_message += "Too many redirects.";
-            break;
-        case duckdb_httplib_openssl::Error::Canceled:
-            err_message += "Request was canceled.";
-            break;
-        case duckdb_httplib_openssl::Error::SSLConnection:
-            err_message += "SSL connection failed.";
-            break;
-        case duckdb_httplib_openssl::Error::SSLLoadingCerts:
-            err_message += "Failed to load SSL certificates.";
-            break;
-        case duckdb_httplib_openssl::Error::SSLServerVerification:
-            err_message += "SSL server verification failed.";
-            break;
-        case duckdb_httplib_openssl::Error::UnsupportedMultipartBoundaryChars:
-            err_message += "Unsupported characters in multipart boundary.";
-            break;
-        case duckdb_httplib_openssl::Error::Compression:
-            err_message += "Error during compression.";
-            break;
-        default:
-            err_message += "Unknown error.";
-            break;
-    }
-    throw std::runtime_error(err_message);
+// The rows of a chunk that issue a request, only those whose arguments are all non-NULL do. Where identical requests
+// may share a response, rows reading the same entries of every argument (constant vectors, dictionary vectors)
+// share one request.
+struct ChunkRows {
+    //! Rows whose arguments are all non-NULL
+    vector<idx_t> rows;
+    //! First row of every group of rows sharing their arguments, a request is built for each
+    vector<idx_t> distinct;
+    //! For each of rows, its group in distinct
+    vector<idx_t> request_of;
+    //! Every argument is a constant vector, so only row 0 is looked at and the result is a constant too
+    bool constant = false;
+};
+
+static ChunkRows GetChunkRows(DataChunk &args, vector<UnifiedVectorFormat> &formats, bool collapse) {
+    ChunkRows result;
+    result.constant = collapse;
+    bool shared = collapse;
+    for (auto &column : args.data) {
+        result.constant = result.constant && column.GetVectorType() == VectorType::CONSTANT_VECTOR;
+        shared = shared && column.GetVectorType() != VectorType::FLAT_VECTOR;
+    }
+    auto count = result.constant ? 1 : args.size();
+    formats.resize(args.ColumnCount());
+    for (idx_t col = 0; col < args.ColumnCount(); col++) {
+        args.data[col].ToUnifiedFormat(count, formats[col]);
+    }
+
+    // Without a flat argument the entries a row reads identify its request, otherwise every row has its own
+    // (identical values are still merged by value in PerformRequests)
+    std::map<vector<idx_t>, idx_t> groups;
+    vector<idx_t> entries(formats.size());
+    for (idx_t row = 0; row < count; row++) {
+        bool valid = true;
+        for (idx_t col = 0; col < formats.size(); col++) {
+            entries[col] = formats[col].sel->get_index(row);
+            valid = valid && formats[col].validity.RowIsValid(entries[col]);
+        }
+        if (!valid) {
+            continue;
+        }
+        result.rows.push_back(row);
+        if (shared) {
+            auto group = groups.emplace(entries, result.distinct.size());
+            if (group.second) {
+                result.distinct.push_back(row);
+            }
+            result.request_of.push_back(group.first->second);
+        } else {
+            result.request_of.push_back(result.distinct.size());
+            result.distinct.push_back(row);
+        }
+    }
+    return result;
 }
 
+static std::string GetString(UnifiedVectorFormat &format, idx_t row) {
+    return UnifiedVectorFormat::GetData<string_t>(format)[format.sel->get_index(row)].GetString();
+}
 
-static void HTTPGetRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-    D_ASSERT(args.data.size() == 1);
-
-    UnaryExecutor::Execute<string_t, string_t>(args.data[0], result, args.size(), [&](string_t input) {
-        std::string url = input.GetString();
-
-        // Use helper to setup client and parse URL
-        auto client_and_path = SetupHttpClient(url);
-        auto &client = client_and_path.first;
-        auto &path = client_and_path.second;
-
-        // Make the GET request
-        auto res = client.Get(path.c_str());
-        if (res) {
-            if (res->status == 200) {
-                return StringVector::AddString(result, res->body);
-            } else {
-                throw std::runtime_error("HTTP GET error: " + std::to_string(res->status) + " - " + res->reason);
+// Reads the headers argument of each row, either "Key: Value" lines or a MAP(VARCHAR, VARCHAR). Rows sharing
+// one value (constant or dictionary vectors, e.g. a MAP{...} literal) have it parsed only once per chunk.
+class HeadersColumn {
+public:
+    HeadersColumn(Vector &vector, UnifiedVectorFormat &format)
+        : vector(vector), format(format), memoize(vector.GetVectorType() != VectorType::FLAT_VECTOR) {
+        if (vector.GetType().id() == LogicalTypeId::MAP) {
+            auto child_count = ListVector::GetListSize(vector);
+            MapVector::GetKeys(vector).ToUnifiedFormat(child_count, key_format);
+            MapVector::GetValues(vector).ToUnifiedFormat(child_count, value_format);
+        }
+    }
+
+    duckdb_httplib_openssl::Headers Get(idx_t row) {
+        auto index = format.sel->get_index(row);
+        if (!memoize) {
+            return Parse(index);
+        }
+        auto entry = parsed.find(index);
+        if (entry == parsed.end()) {
+            entry = parsed.emplace(index, Parse(index)).first;
+        }
+        return entry->second;
+    }
+
+private:
+    duckdb_httplib_openssl::Headers Parse(idx_t index) {
+        if (vector.GetType().id() != LogicalTypeId::MAP) {
+            auto &headers = UnifiedVectorFormat::GetData<string_t>(format)[index];
+            return ParseHttpHeaders(headers.GetData(), headers.GetSize());
+        }
+        duckdb_httplib_openssl::Headers headers;
+        auto list = UnifiedVectorFormat::GetData<list_entry_t>(format)[index];
+        auto keys = UnifiedVectorFormat::GetData<string_t>(key_format);
+        auto values = UnifiedVectorFormat::GetData<string_t>(value_format);
+        for (idx_t child = list.offset; child < list.offset + list.length; child++) {
+            auto key_index = key_format.sel->get_index(child);
+            auto value_index = value_format.sel->get_index(child);
+            if (!key_format.validity.RowIsValid(key_index) || !value_format.validity.RowIsValid(value_index)) {
+                continue;
             }
+            headers.emplace(keys[key_index].GetString(), values[value_index].GetString());
+        }
+        return headers;
+    }
+
+    Vector &vector;
+    UnifiedVectorFormat &format;
+    UnifiedVectorFormat key_format;
+    UnifiedVectorFormat value_format;
+    bool memoize;
+    std::unordered_map<idx_t, duckdb_httplib_openssl::Headers> parsed;
+};
+
+// Upper case the method of an http_request row, rejecting what cannot be sent as one
+static std::string GetMethod(UnifiedVectorFormat &format, idx_t row) {
+    auto method = StringUtil::Upper(GetString(format, row));
+    if (method.empty() || method.find_first_of(" \t\r\n") != std::string::npos) {
+        throw InvalidInputException("Invalid HTTP method '%s'", method);
+    }
+    return method;
+}
+
+// Whether rows of the chunk may share a request, which they only may where identical requests share a response.
+// Of http_request (method is empty) only a constant method is known for the whole chunk.
+static bool CollapseChunkRows(DataChunk &args, const std::string &method, const HttpClientSettings &settings) {
+    if (!method.empty()) {
+        return HttpMethodShareable(method, settings);
+    }
+    auto &methods = args.data[0];
+    if (methods.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(methods)) {
+        auto constant = ConstantVector::GetData<string_t>(methods)[0].GetString();
+        return HttpMethodShareable(StringUtil::Upper(constant), settings);
+    }
+    return settings.deduplicate && settings.deduplicate_writes;
+}
+
+// Build the requests of a chunk from its arguments: (url[, headers]) or (url, headers, body), preceded by the
+// method when method is empty (http_request)
+static vector<HttpRequest> BuildRequests(DataChunk &args, ChunkRows &rows, const std::string &method,
+                                         const HttpClientSettings &settings) {
+    vector<UnifiedVectorFormat> formats;
+    rows = GetChunkRows(args, formats, CollapseChunkRows(args, method, settings));
+
+    idx_t url_col = method.empty() ? 1 : 0;
+    idx_t headers_col = url_col + 1;
+    idx_t body_col = url_col + 2;
+    vector<HttpRequest> requests(rows.distinct.size());
+    unique_ptr<HeadersColumn> headers;
+    if (args.ColumnCount() > headers_col) {
+        headers = make_uniq<HeadersColumn>(args.data[headers_col], formats[headers_col]);
+    }
+    for (idx_t i = 0; i < rows.distinct.size(); i++) {
+        auto &request = requests[i];
+        auto row = rows.distinct[i];
+        request.method = method.empty() ? GetMethod(formats[0], row) : method;
+        request.url = GetString(formats[url_col], row);
+        if (headers) {
+            request.headers = headers->Get(row);
+        }
+        if (args.ColumnCount() > body_col) {
+            // The body is sent straight from the input vector, it outlives the requests of the chunk
+            auto &body_format = formats[body_col];
+            auto &body = UnifiedVectorFormat::GetData<string_t>(body_format)[body_format.sel->get_index(row)];
+            request.body_data = body.GetData();
+            request.body_size = body.GetSize();
+        }
+    }
+    return requests;
+}
+
+// Send the requests concurrently; with raise_errors the first failed or non-200 response fails the query.
+// Identical GET and HEAD requests share one response object, within the chunk and (through HttpQueryState) the
+// query; other methods only with http_client_deduplicate_writes.
+static vector<shared_ptr<HttpResponse>> PerformRequests(ExpressionState &state, const HttpClientSettings &settings,
+                                                        vector<HttpRequest> &requests, bool raise_errors) {
+    if (requests.empty()) {
+        // Nothing but NULLs, no client is needed
+        return vector<shared_ptr<HttpResponse>>();
+    }
+    auto &context = state.GetContext();
+    auto client_state = HttpClientState::Get(context);
+
+    // Split the URLs once here rather than for every attempt on the I/O threads
+    HttpUrlResolver resolver(settings, &client_state->metrics);
+    for (auto &request : requests) {
+        resolver.Resolve(request);
+    }
+
+    // Map every request to the first identical one in the chunk, only those are dispatched. Requests of a method
+    // that may not be shared are all sent, their key stays empty.
+    vector<idx_t> unique_requests;
+    vector<idx_t> request_map(requests.size());
+    vector<std::string> keys;
+    auto query_state = HttpQueryState::Get(context);
+    std::unordered_map<std::string, idx_t> seen;
+    for (idx_t i = 0; i < requests.size(); i++) {
+        if (!HttpMethodShareable(requests[i].method, settings)) {
+            request_map[i] = unique_requests.size();
+            unique_requests.push_back(i);
+            keys.emplace_back();
+            continue;
+        }
+        auto key = requests[i].Key();
+        auto entry = seen.emplace(key, unique_requests.size());
+        if (entry.second) {
+            unique_requests.push_back(i);
+            keys.push_back(std::move(key));
+        } else {
+            auto &first = requests[unique_requests[entry.first->second]];
+            if (!requests[i].SameBody(first.BodyData(), first.BodySize())) {
+                // The key only carries a hash of the body, this one merely collides
+                request_map[i] = unique_requests.size();
+                unique_requests.push_back(i);
+                keys.emplace_back();
+                continue;
+            }
+        }
+        request_map[i] = entry.first->second;
+    }
+
+    vector<shared_ptr<HttpResponse>> unique_responses(unique_requests.size());
+    client_state->executor.Run(unique_requests.size(), settings.max_concurrency, settings.io_threads, [&](idx_t i) {
+        auto &request = requests[unique_requests[i]];
+        if (context.interrupted) {
+            throw InterruptException();
+        }
+        auto perform = [&]() {
+            // Holding a slot of the query's scheduler keeps all its threads together within
+            // http_client_query_concurrency
+            HttpSchedulerSlot slot(query_state->scheduler, settings.query_concurrency, settings.interrupted);
+            if (!slot.Granted()) {
+                throw InterruptException();
+            }
+            return PerformHttpRequest(*client_state, settings, request);
+        };
+        if (!keys[i].empty()) {
+            unique_responses[i] =
+                query_state->deduplicator.Perform(keys[i], request, settings.dedup_size, settings.interrupted, perform);
         } else {
-            // Handle errors
-            HandleHttpError(res, "GET");
+            unique_responses[i] = make_shared_ptr<HttpResponse>(perform());
+        }
+        if (context.interrupted) {
+            throw InterruptException();
+        }
+        if (raise_errors) {
+            CheckHttpResponse(*unique_responses[i], request.method);
         }
-        // Ensure a return value in case of an error
-        return string_t();
     });
+
+    vector<shared_ptr<HttpResponse>> responses(requests.size());
+    for (idx_t i = 0; i < requests.size(); i++) {
+        responses[i] = unique_responses[request_map[i]];
+    }
+    return responses;
+}
+
+// Copy the fetched bodies into the result vector in row order, rows with a NULL argument stay NULL.
+// StringVector::AddString is not thread-safe so this happens after all requests are done, and rows sharing
+// a response share one copy of its body.
+static void WriteResponseBodies(Vector &result, idx_t count, const ChunkRows &rows,
+                                const vector<shared_ptr<HttpResponse>> &responses) {
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto result_data = FlatVector::GetData<string_t>(result);
+    auto &result_validity = FlatVector::Validity(result);
+    if (rows.constant) {
+        count = 1;
+    }
+    for (idx_t row = 0; row < count; row++) {
+        result_validity.SetInvalid(row);
+    }
+    std::unordered_map<const HttpResponse *, string_t> copied;
+    for (idx_t i = 0; i < rows.rows.size(); i++) {
+        auto &response = responses[rows.request_of[i]];
+        result_validity.SetValid(rows.rows[i]);
+        auto entry = copied.find(response.get());
+        if (entry == copied.end()) {
+            entry = copied.emplace(response.get(), StringVector::AddString(result, response->body)).first;
+        }
+        result_data[rows.rows[i]] = entry->second;
+    }
+    if (rows.constant) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+static LogicalType HttpResponseType() {
+    child_list_t<LogicalType> children;
+    children.emplace_back("status", LogicalType::INTEGER);
+    children.emplace_back("reason", LogicalType::VARCHAR);
+    children.emplace_back("headers", HttpHeadersType());
+    children.emplace_back("body", LogicalType::BLOB);
+    children.emplace_back("elapsed_ms", LogicalType::DOUBLE);
+    return LogicalType::STRUCT(std::move(children));
+}
+
+// Write the responses as HttpResponseType() structs. A request that got no response has a NULL status and
+// the error in reason.
+static void WriteResponseStructs(Vector &result, idx_t count, const ChunkRows &rows,
+                                 const vector<shared_ptr<HttpResponse>> &responses) {
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    if (rows.constant) {
+        count = 1;
+    }
+    auto &children = StructVector::GetEntries(result);
+    auto &status_vector = *children[0];
+    auto &reason_vector = *children[1];
+    auto &headers_vector = *children[2];
+    auto &body_vector = *children[3];
+    auto &elapsed_vector = *children[4];
+
+    std::unordered_map<const HttpResponse *, string_t> copied_bodies;
+    idx_t next = 0;
+    for (idx_t row = 0; row < count; row++) {
+        if (next >= rows.rows.size() || rows.rows[next] != row) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        auto &response = *responses[rows.request_of[next++]];
+        FlatVector::SetNull(result, row, false);
+        FlatVector::SetNull(status_vector, row, !response.received);
+        FlatVector::SetNull(reason_vector, row, false);
+        FlatVector::SetNull(body_vector, row, !response.received);
+        FlatVector::SetNull(elapsed_vector, row, false);
+
+        FlatVector::GetData<double>(elapsed_vector)[row] = response.elapsed_ms;
+        if (!response.received) {
+            FlatVector::GetData<string_t>(reason_vector)[row] = StringVector::AddString(reason_vector, response.error);
+            headers_vector.SetValue(row, Value(HttpHeadersType()));
+            continue;
+        }
+        FlatVector::GetData<int32_t>(status_vector)[row] = response.status;
+        FlatVector::GetData<string_t>(reason_vector)[row] = StringVector::AddString(reason_vector, response.reason);
+        headers_vector.SetValue(row, HttpHeadersToValue(response.headers));
+        auto body = copied_bodies.find(&response);
+        if (body == copied_bodies.end()) {
+            body = copied_bodies.emplace(&response, StringVector::AddStringOrBlob(body_vector, response.body)).first;
+        }
+        FlatVector::GetData<string_t>(body_vector)[row] = body->second;
+    }
+    if (rows.constant) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// The bodies were copied into the result, hand the buffers of responses nothing else refers to (the query's
+// de-duplication memo, a cache) back to the pool for the next chunk
+static void RecycleResponseBodies(ExpressionState &state, const HttpClientSettings &settings,
+                                  vector<shared_ptr<HttpResponse>> &responses) {
+    if (responses.empty()) {
+        return;
+    }
+    std::unordered_map<HttpResponse *, idx_t> references;
+    for (auto &response : responses) {
+        references[response.get()]++;
+    }
+    auto client_state = HttpClientState::Get(state.GetContext());
+    for (auto &response : responses) {
+        auto entry = references.find(response.get());
+        if (entry != references.end() && static_cast<idx_t>(response.use_count()) == entry->second) {
+            client_state->buffers.Give(std::move(response->body), settings.buffer_pool_size);
+            references.erase(entry);
+        }
+    }
+}
+
+// Send the chunk's requests and return their bodies, a failed or unsuccessful request fails the query
+static void HTTPBodyRequest(DataChunk &args, ExpressionState &state, Vector &result, const std::string &method) {
+    auto settings = HttpClientSettings::Get(state.GetContext());
+    ChunkRows rows;
+    auto requests = BuildRequests(args, rows, method, settings);
+    auto responses = PerformRequests(state, settings, requests, true);
+    WriteResponseBodies(result, args.size(), rows, responses);
+    RecycleResponseBodies(state, settings, responses);
+}
+
+// Send the chunk's requests and return the whole responses, failures included
+static void HTTPResponseRequest(DataChunk &args, ExpressionState &state, Vector &result, const std::string &method) {
+    auto settings = HttpClientSettings::Get(state.GetContext());
+    ChunkRows rows;
+    auto requests = BuildRequests(args, rows, method, settings);
+    auto responses = PerformRequests(state, settings, requests, false);
+    WriteResponseStructs(result, args.size(), rows, responses);
+    RecycleResponseBodies(state, settings, responses);
+}
+
+static void HTTPGetRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
+    HTTPBodyRequest(args, state, result, "GET");
 }
 
 static void HTTPPostRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
     D_ASSERT(args.data.size() == 3);
+    HTTPBodyRequest(args, state, result, "POST");
+}
 
-    auto &url_vector = args.data[0];
-    auto &headers_vector = args.data[1];
-    auto &body_vector = args.data[2];
-
-    TernaryExecutor::Execute<string_t, string_t, string_t, string_t>(
-        url_vector, headers_vector, body_vector, result, args.size(),
-        [&](string_t url, string_t headers, string_t body) {
-            std::string url_str = url.GetString();
-
-            // Use helper to setup client and parse URL
-            auto client_and_path = SetupHttpClient(url_str);
-            auto &client = client_and_path.first;
-            auto &path = client_and_path.second;
-
-            // Prepare headers
-            duckdb_httplib_openssl::Headers header_map;
-            std::istringstream header_stream(headers.GetString());
-            std::string header;
-            while (std::getline(header_stream, header)) {
-                size_t colon_pos = header.find(':');
-                if (colon_pos != std::string::npos) {
-                    std::string key = header.substr(0, colon_pos);
-                    std::string value = header.substr(colon_pos + 1);
-                    // Trim leading and trailing whitespace
-                    key.erase(0, key.find_first_not_of(" \t"));
-                    key.erase(key.find_last_not_of(" \t") + 1);
-                    value.erase(0, value.find_first_not_of(" \t"));
-                    value.erase(value.find_last_not_of(" \t") + 1);
-                    header_map.emplace(key, value);
-                }
-            }
+static void HTTPPutRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 3);
+    HTTPBodyRequest(args, state, result, "PUT");
+}
 
-            // Make the POST request with headers and body
-            auto res = client.Post(path.c_str(), header_map, body.GetString(), "application/json");
-            if (res) {
-                if (res->status == 200) {
-                    return StringVector::AddString(result, res->body);
-                } else {
-                    throw std::runtime_error("HTTP POST error: " + std::to_string(res->status) + " - " + res->reason);
-                }
-            } else {
-                // Handle errors
-                HandleHttpError(res, "POST");
-            }
-            // Ensure a return value in case of an error
-            return string_t();
-        });
+static void HTTPPatchRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 3);
+    HTTPBodyRequest(args, state, result, "PATCH");
 }
 
+static void HTTPDeleteRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
+    HTTPBodyRequest(args, state, result, "DELETE");
+}
+
+static void HTTPGetExRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
+    HTTPResponseRequest(args, state, result, "GET");
+}
+
+static void HTTPPostExRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 3);
+    HTTPResponseRequest(args, state, result, "POST");
+}
+
+static void HTTPHeadRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
+    HTTPResponseRequest(args, state, result, "HEAD");
+}
+
+static void HTTPGenericRequestFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    D_ASSERT(args.data.size() == 4);
+    HTTPResponseRequest(args, state, result, std::string());
+}
+
+void HTTPFunctions::RegisterHTTPRequestFunction(DatabaseInstance &instance) {
+    // Headers are given either as "Key: Value" lines or as a MAP(VARCHAR, VARCHAR)
+    vector<LogicalType> header_types {LogicalType::VARCHAR, HttpHeadersType()};
 
-static void LoadInternal(DatabaseInstance &instance) {
     ScalarFunctionSet http_get("http_get");
     http_get.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::VARCHAR, HTTPGetRequestFunction));
+    for (auto &headers : header_types) {
+        http_get.AddFunction(
+            ScalarFunction({LogicalType::VARCHAR, headers}, LogicalType::VARCHAR, HTTPGetRequestFunction));
+    }
     ExtensionUtil::RegisterFunction(instance, http_get);
 
     ScalarFunctionSet http_post("http_post");
-    http_post.AddFunction(ScalarFunction(
-        {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-        LogicalType::VARCHAR, HTTPPostRequestFunction));
+    for (auto &headers : header_types) {
+        http_post.AddFunction(ScalarFunction(
+            {LogicalType::VARCHAR, headers, LogicalType::VARCHAR},
+            LogicalType::VARCHAR, HTTPPostRequestFunction));
+    }
     ExtensionUtil::RegisterFunction(instance, http_post);
+
+    // Variants returning the whole response, failures are reported in the result instead of raised
+    ScalarFunctionSet http_get_ex("http_get_ex");
+    http_get_ex.AddFunction(ScalarFunction({LogicalType::VARCHAR}, HttpResponseType(), HTTPGetExRequestFunction));
+    for (auto &headers : header_types) {
+        http_get_ex.AddFunction(
+            ScalarFunction({LogicalType::VARCHAR, headers}, HttpResponseType(), HTTPGetExRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_get_ex);
+
+    ScalarFunctionSet http_post_ex("http_post_ex");
+    for (auto &headers : header_types) {
+        http_post_ex.AddFunction(ScalarFunction(
+            {LogicalType::VARCHAR, headers, LogicalType::VARCHAR},
+            HttpResponseType(), HTTPPostExRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_post_ex);
+
+    // Further methods, sharing the pooled and concurrent request path of http_get and http_post
+    ScalarFunctionSet http_put("http_put");
+    ScalarFunctionSet http_patch("http_patch");
+    for (auto &headers : header_types) {
+        http_put.AddFunction(ScalarFunction({LogicalType::VARCHAR, headers, LogicalType::VARCHAR},
+                                            LogicalType::VARCHAR, HTTPPutRequestFunction));
+        http_patch.AddFunction(ScalarFunction({LogicalType::VARCHAR, headers, LogicalType::VARCHAR},
+                                              LogicalType::VARCHAR, HTTPPatchRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_put);
+    ExtensionUtil::RegisterFunction(instance, http_patch);
+
+    ScalarFunctionSet http_delete("http_delete");
+    http_delete.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::VARCHAR, HTTPDeleteRequestFunction));
+    for (auto &headers : header_types) {
+        http_delete.AddFunction(
+            ScalarFunction({LogicalType::VARCHAR, headers}, LogicalType::VARCHAR, HTTPDeleteRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_delete);
+
+    // HEAD has no body to return, so it returns the response with status and headers
+    ScalarFunctionSet http_head("http_head");
+    http_head.AddFunction(ScalarFunction({LogicalType::VARCHAR}, HttpResponseType(), HTTPHeadRequestFunction));
+    for (auto &headers : header_types) {
+        http_head.AddFunction(
+            ScalarFunction({LogicalType::VARCHAR, headers}, HttpResponseType(), HTTPHeadRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_head);
+
+    ScalarFunctionSet http_request("http_request");
+    for (auto &headers : header_types) {
+        http_request.AddFunction(
+            ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, headers, LogicalType::VARCHAR},
+                           HttpResponseType(), HTTPGenericRequestFunction));
+    }
+    ExtensionUtil::RegisterFunction(instance, http_request);
+}
+
+static void LoadInternal(DatabaseInstance &instance) {
+    HttpClientSettings::Register(instance);
+    HTTPFunctions::Register(instance);
+
+    // http_client_prewarm given in the database config, before the extension was loaded: warm those hosts now
+    Connection con(instance);
+    auto settings = HttpClientSettings::Get(*con.context);
+    if (!settings.prewarm.empty()) {
+        PrewarmHttpHosts(*HttpClientState::Get(instance), settings, settings.prewarm, 1);
+    }
 }
 
 void HttpClientExtension::Load(DuckDB &db) {
@@ -0,0 +1,320 @@
+#include "http_client_settings.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/config.hpp"
+#include "http_client_state.hpp"
+#include "http_request.hpp"
+
+namespace duckdb {
+
+// Parse a size such as '64MB', plain numbers are bytes
+static idx_t ParseByteSize(const std::string &value) {
+    if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+        return std::stoull(value);
+    }
+    auto size = DBConfig::ParseMemoryLimit(value);
+    return size == DConstants::INVALID_INDEX ? NumericLimits<idx_t>::Maximum() : size;
+}
+
+// Parse 'host=address, host=address' pairs
+static std::unordered_map<std::string, std::string> ParseDnsOverrides(const std::string &value) {
+    std::unordered_map<std::string, std::string> overrides;
+    for (auto &entry : StringUtil::Split(value, ',')) {
+        StringUtil::Trim(entry);
+        if (entry.empty()) {
+            continue;
+        }
+        auto pos = entry.find('=');
+        if (pos == std::string::npos) {
+            throw InvalidInputException("Invalid http_client_dns_overrides entry '%s', expected host=address", entry);
+        }
+        auto host = entry.substr(0, pos);
+        auto address = entry.substr(pos + 1);
+        StringUtil::Trim(host);
+        StringUtil::Trim(address);
+        overrides[StringUtil::Lower(host)] = address;
+    }
+    return overrides;
+}
+
+static void SetDnsOverrides(ClientContext &context, SetScope scope, Value &parameter) {
+    ParseDnsOverrides(parameter.ToString());
+}
+
+static std::string ParseBatchFormat(const std::string &value) {
+    auto format = StringUtil::Lower(value);
+    if (format != "ndjson" && format != "json") {
+        throw InvalidInputException("Invalid http_client_batch_format '%s', expected 'ndjson' or 'json'", value);
+    }
+    return format;
+}
+
+static void SetBatchFormat(ClientContext &context, SetScope scope, Value &parameter) {
+    ParseBatchFormat(parameter.ToString());
+}
+
+// Parse 'url, url' lists
+static vector<std::string> ParsePrewarmUrls(const std::string &value) {
+    vector<std::string> urls;
+    for (auto &url : StringUtil::Split(value, ',')) {
+        StringUtil::Trim(url);
+        if (!url.empty()) {
+            urls.push_back(url);
+        }
+    }
+    return urls;
+}
+
+static void SetPrewarm(ClientContext &context, SetScope scope, Value &parameter) {
+    // Warm the hosts right away, in the background; an invalid URL fails the SET
+    if (parameter.IsNull()) {
+        return;
+    }
+    PrewarmHttpHosts(*HttpClientState::Get(context), HttpClientSettings::Get(context),
+                     ParsePrewarmUrls(parameter.ToString()), 1);
+}
+
+static void SetCacheSize(ClientContext &context, SetScope scope, Value &parameter) {
+    // Validate eagerly and release memory right away when the cache shrinks
+    auto cache_size = ParseByteSize(parameter.ToString());
+    HttpClientState::Get(context)->response_cache.Shrink(cache_size);
+}
+
+// Reject a malformed size when it is set rather than on the next request that reads it
+static void ValidateByteSize(ClientContext &context, SetScope scope, Value &parameter) {
+    ParseByteSize(parameter.ToString());
+}
+
+static void SetBufferPoolSize(ClientContext &context, SetScope scope, Value &parameter) {
+    auto buffer_pool_size = ParseByteSize(parameter.ToString());
+    HttpClientState::Get(context)->buffers.Shrink(buffer_pool_size);
+}
+
+void HttpClientSettings::Register(DatabaseInstance &instance) {
+    auto &config = DBConfig::GetConfig(instance);
+    HttpClientSettings defaults;
+
+    config.AddExtensionOption("http_client_keep_alive",
+                              "Keep HTTP connections open and reuse them across rows and queries",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.keep_alive));
+    config.AddExtensionOption("http_client_max_connections_per_host",
+                              "Maximum number of pooled HTTP connections per (scheme, host, port)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.max_connections_per_host));
+    config.AddExtensionOption("http_client_adaptive_concurrency",
+                              "Halve the connections used per host on 429/5xx or errors and grow them back while "
+                              "requests succeed, up to http_client_max_connections_per_host",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.adaptive_concurrency));
+    config.AddExtensionOption("http_client_pool_idle_timeout",
+                              "Seconds an idle pooled HTTP connection is kept open before it is closed",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.pool_idle_timeout));
+    config.AddExtensionOption("http_client_heartbeat_interval",
+                              "Seconds between the requests that keep connections pinned by http_client_prewarm "
+                              "open (0 disables them)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.heartbeat_interval));
+    config.AddExtensionOption("http_client_prewarm",
+                              "URLs, as 'url, url', whose hosts get a connection opened and pinned when the "
+                              "extension is loaded or this is set",
+                              LogicalType::VARCHAR, Value(""), SetPrewarm);
+    config.AddExtensionOption("http_client_connect_timeout", "Seconds to wait for a connection to be established",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.connect_timeout));
+    config.AddExtensionOption("http_client_read_timeout", "Seconds to wait for data while reading a response",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.read_timeout));
+    config.AddExtensionOption("http_client_write_timeout", "Seconds to wait while sending a request",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.write_timeout));
+    config.AddExtensionOption("http_client_timeout",
+                              "Seconds a request may take overall including its retries (0 = no limit)",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.timeout));
+    config.AddExtensionOption("http_client_max_retries",
+                              "How often a request failing with a transient error or status (429, 5xx) is retried",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.max_retries));
+    config.AddExtensionOption("http_client_retry_backoff",
+                              "Seconds before the first retry, doubled (with jitter) for every further one",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.retry_backoff));
+    config.AddExtensionOption("http_client_rate_limit",
+                              "Maximum requests per second sent to one host (0 = no limit)",
+                              LogicalType::DOUBLE, Value::DOUBLE(defaults.rate_limit));
+    config.AddExtensionOption("http_client_max_concurrency",
+                              "Maximum number of requests of a chunk that are in flight at the same time (1 = sequential)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.max_concurrency));
+    config.AddExtensionOption("http_client_query_concurrency",
+                              "Maximum number of requests of one query in flight at the same time across all its "
+                              "threads (0 = no limit)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.query_concurrency));
+    config.AddExtensionOption("http_client_io_threads",
+                              "Number of I/O threads shared by all queries that HTTP requests are dispatched to",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.io_threads));
+    config.AddExtensionOption("http_client_cache_size",
+                              "Maximum memory used to cache GET responses that allow caching (e.g. '64MB', 0 disables)",
+                              LogicalType::VARCHAR, Value("64MB"), SetCacheSize);
+    config.AddExtensionOption("http_client_deduplicate",
+                              "Send identical requests (method, url, headers, body) of a query only once",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.deduplicate));
+    config.AddExtensionOption("http_client_deduplicate_writes",
+                              "Also send identical POST, PUT, PATCH and DELETE requests of a query only once, not "
+                              "just GET and HEAD",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.deduplicate_writes));
+    config.AddExtensionOption("http_client_dedup_size",
+                              "Memory per query for remembering responses of de-duplicated requests (e.g. '64MB')",
+                              LogicalType::VARCHAR, Value("64MB"), ValidateByteSize);
+    config.AddExtensionOption("http_client_buffer_pool_size",
+                              "Maximum memory of idle response buffers kept for reuse (e.g. '16MB', 0 disables)",
+                              LogicalType::VARCHAR, Value("16MB"), SetBufferPoolSize);
+    config.AddExtensionOption("http_client_download_segments",
+                              "Concurrent Range requests a large GET response is downloaded with (1 disables it)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.download_segments));
+    config.AddExtensionOption("http_client_segment_size",
+                              "Bytes fetched per Range request of a segmented download (e.g. '8MB')",
+                              LogicalType::VARCHAR, Value("8MB"), ValidateByteSize);
+    config.AddExtensionOption("http_client_dns_cache_ttl",
+                              "Seconds a resolved host address is reused for new connections (0 disables the cache)",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.dns_cache_ttl));
+    config.AddExtensionOption("http_client_dns_overrides",
+                              "Fixed addresses for host names, as 'host=address, host=address'",
+                              LogicalType::VARCHAR, Value(""), SetDnsOverrides);
+    config.AddExtensionOption("http_client_compression",
+                              "Ask for gzip/deflate compressed responses (Accept-Encoding) and decompress them",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.compression));
+    config.AddExtensionOption("http_client_compress_requests",
+                              "Send request bodies gzip compressed (Content-Encoding: gzip)",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(defaults.compress_requests));
+    config.AddExtensionOption("http_client_batch_rows", "Maximum rows http_post_batch sends in one request",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.batch_rows));
+    config.AddExtensionOption("http_client_batch_size",
+                              "Maximum body size of one http_post_batch request (e.g. '1MB')",
+                              LogicalType::VARCHAR, Value("1MB"), ValidateByteSize);
+    config.AddExtensionOption("http_client_batch_format",
+                              "How http_post_batch joins rows: 'ndjson' (one per line) or 'json' (an array)",
+                              LogicalType::VARCHAR, Value(defaults.batch_format), SetBatchFormat);
+    config.AddExtensionOption("http_client_max_line_size",
+                              "Maximum length of one line returned by read_http_lines (e.g. '64MB')",
+                              LogicalType::VARCHAR, Value("64MB"), ValidateByteSize);
+    config.AddExtensionOption("http_client_base_url",
+                              "URL that request URLs without a scheme (e.g. '/users?id=1') are resolved against",
+                              LogicalType::VARCHAR, Value(""));
+    config.AddExtensionOption("http_client_cache_path",
+                              "Directory of the persistent GET response cache, empty disables it",
+                              LogicalType::VARCHAR, Value(""));
+    config.AddExtensionOption("http_client_disk_cache_size",
+                              "Maximum size of the persistent response cache directory (e.g. '1GB')",
+                              LogicalType::VARCHAR, Value("1GB"), ValidateByteSize);
+    config.AddExtensionOption("http_client_disk_cache_ttl",
+                              "Seconds a response in the persistent cache stays valid, 0 keeps it until evicted",
+                              LogicalType::UBIGINT, Value::UBIGINT(defaults.disk_cache_ttl));
+}
+
+HttpClientSettings HttpClientSettings::Get(ClientContext &context) {
+    HttpClientSettings settings;
+    settings.interrupted = &context.interrupted;
+    settings.memory_limit = DBConfig::GetConfig(context).options.maximum_memory;
+    Value value;
+
+    if (context.TryGetCurrentSetting("http_client_keep_alive", value) && !value.IsNull()) {
+        settings.keep_alive = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_max_connections_per_host", value) && !value.IsNull()) {
+        settings.max_connections_per_host = MaxValue<idx_t>(UBigIntValue::Get(value), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_adaptive_concurrency", value) && !value.IsNull()) {
+        settings.adaptive_concurrency = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_pool_idle_timeout", value) && !value.IsNull()) {
+        settings.pool_idle_timeout = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_heartbeat_interval", value) && !value.IsNull()) {
+        settings.heartbeat_interval = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_prewarm", value) && !value.IsNull()) {
+        settings.prewarm = ParsePrewarmUrls(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_connect_timeout", value) && !value.IsNull()) {
+        settings.connect_timeout = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_read_timeout", value) && !value.IsNull()) {
+        settings.read_timeout = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_write_timeout", value) && !value.IsNull()) {
+        settings.write_timeout = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_timeout", value) && !value.IsNull()) {
+        settings.timeout = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_max_retries", value) && !value.IsNull()) {
+        settings.max_retries = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_retry_backoff", value) && !value.IsNull()) {
+        settings.retry_backoff = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_rate_limit", value) && !value.IsNull()) {
+        settings.rate_limit = MaxValue<double>(DoubleValue::Get(value), 0);
+    }
+    if (context.TryGetCurrentSetting("http_client_max_concurrency", value) && !value.IsNull()) {
+        settings.max_concurrency = MaxValue<idx_t>(UBigIntValue::Get(value), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_query_concurrency", value) && !value.IsNull()) {
+        settings.query_concurrency = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_io_threads", value) && !value.IsNull()) {
+        settings.io_threads = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_cache_size", value) && !value.IsNull()) {
+        settings.cache_size = ParseByteSize(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_deduplicate", value) && !value.IsNull()) {
+        settings.deduplicate = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_deduplicate_writes", value) && !value.IsNull()) {
+        settings.deduplicate_writes = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_dedup_size", value) && !value.IsNull()) {
+        settings.dedup_size = ParseByteSize(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_buffer_pool_size", value) && !value.IsNull()) {
+        settings.buffer_pool_size = ParseByteSize(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_download_segments", value) && !value.IsNull()) {
+        settings.download_segments = MaxValue<idx_t>(UBigIntValue::Get(value), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_segment_size", value) && !value.IsNull()) {
+        settings.segment_size = MaxValue<idx_t>(ParseByteSize(value.ToString()), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_dns_cache_ttl", value) && !value.IsNull()) {
+        settings.dns_cache_ttl = UBigIntValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_dns_overrides", value) && !value.IsNull() &&
+        !value.ToString().empty()) {
+        settings.dns_overrides = ParseDnsOverrides(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_compression", value) && !value.IsNull()) {
+        settings.compression = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_compress_requests", value) && !value.IsNull()) {
+        settings.compress_requests = BooleanValue::Get(value);
+    }
+    if (context.TryGetCurrentSetting("http_client_batch_rows", value) && !value.IsNull()) {
+        settings.batch_rows = MaxValue<idx_t>(UBigIntValue::Get(value), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_batch_size", value) && !value.IsNull()) {
+        settings.batch_size = MaxValue<idx_t>(ParseByteSize(value.ToString()), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_batch_format", value) && !value.IsNull()) {
+        settings.batch_format = ParseBatchFormat(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_max_line_size", value) && !value.IsNull()) {
+        settings.max_line_size = MaxValue<idx_t>(ParseByteSize(value.ToString()), 1);
+    }
+    if (context.TryGetCurrentSetting("http_client_base_url", value) && !value.IsNull()) {
+        settings.base_url = value.ToString();
+    }
+    if (context.TryGetCurrentSetting("http_client_cache_path", value) && !value.IsNull()) {
+        settings.cache_path = value.ToString();
+    }
+    if (context.TryGetCurrentSetting("http_client_disk_cache_size", value) && !value.IsNull()) {
+        settings.disk_cache_size = ParseByteSize(value.ToString());
+    }
+    if (context.TryGetCurrentSetting("http_client_disk_cache_ttl", value) && !value.IsNull()) {
+        settings.disk_cache_ttl = UBigIntValue::Get(value);
+    }
+    return settings;
+}
+
+} // namespace duckdb
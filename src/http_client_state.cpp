@@ -0,0 +1,14 @@
+#include "http_client_state.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+shared_ptr<HttpClientState> HttpClientState::Get(ClientContext &context) {
+    return ObjectCache::GetObjectCache(context).GetOrCreate<HttpClientState>(CACHE_KEY);
+}
+
+shared_ptr<HttpClientState> HttpClientState::Get(DatabaseInstance &instance) {
+    return instance.GetObjectCache().GetOrCreate<HttpClientState>(CACHE_KEY);
+}
+
+} // namespace duckdb
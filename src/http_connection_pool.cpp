@@ -0,0 +1,456 @@
+#include "http_connection_pool.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <map>
+#include <system_error>
+
+namespace duckdb {
+
+std::string HttpEndpoint::ToString() const {
+    // IPv6 literals need their brackets back
+    auto host_part = host.find(':') != std::string::npos ? "[" + host + "]" : host;
+    return scheme + "://" + host_part + ":" + std::to_string(port);
+}
+
+HttpUrl HttpUrl::Parse(const std::string &url) {
+    HttpUrl result;
+    auto &endpoint = result.endpoint;
+    std::string rest = url;
+
+    size_t pos = rest.find("://");
+    if (pos != std::string::npos) {
+        endpoint.scheme = StringUtil::Lower(rest.substr(0, pos));
+        rest.erase(0, pos + 3);
+    } else {
+        endpoint.scheme = "http";
+    }
+    if (endpoint.scheme != "http" && endpoint.scheme != "https") {
+        throw std::runtime_error("Unsupported URL scheme '" + endpoint.scheme + "' in " + url);
+    }
+
+    // Split the authority from the request target
+    pos = rest.find_first_of("/?#");
+    std::string authority = rest.substr(0, pos);
+    result.path = ParseTarget(rest, pos == std::string::npos ? rest.size() : pos);
+
+    std::string port;
+    if (!authority.empty() && authority[0] == '[') {
+        pos = authority.find(']');
+        if (pos == std::string::npos) {
+            throw std::runtime_error("Invalid IPv6 host in URL: " + url);
+        }
+        endpoint.host = authority.substr(1, pos - 1);
+        if (pos + 1 < authority.size() && authority[pos + 1] == ':') {
+            port = authority.substr(pos + 2);
+        }
+    } else {
+        pos = authority.rfind(':');
+        endpoint.host = authority.substr(0, pos);
+        if (pos != std::string::npos) {
+            port = authority.substr(pos + 1);
+        }
+    }
+    if (endpoint.host.empty()) {
+        throw std::runtime_error("Invalid URL, missing host: " + url);
+    }
+
+    if (port.empty()) {
+        endpoint.port = endpoint.IsSSL() ? 443 : 80;
+    } else {
+        if (port.size() > 5 || port.find_first_not_of("0123456789") != std::string::npos) {
+            throw std::runtime_error("Invalid port '" + port + "' in URL: " + url);
+        }
+        endpoint.port = std::stoi(port);
+    }
+    return result;
+}
+
+std::string HttpUrl::ParseTarget(const std::string &url, idx_t start) {
+    // A bare "?query" still needs a leading slash, a fragment is never sent
+    auto end = url.find('#', start);
+    auto target = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    if (target.empty() || target[0] != '/') {
+        target.insert(0, "/");
+    }
+    return target;
+}
+
+HttpConnection::HttpConnection(HttpConnectionPool &pool_p, std::string key_p,
+                               unique_ptr<duckdb_httplib_openssl::Client> client_p)
+    : pool(&pool_p), key(std::move(key_p)), client(std::move(client_p)) {
+}
+
+HttpConnection::HttpConnection(HttpConnection &&other) noexcept
+    : pool(other.pool), key(std::move(other.key)), client(std::move(other.client)), reusable(other.reusable),
+      connect_failed(other.connect_failed), reused(other.reused), resolve_ms(other.resolve_ms),
+      address(std::move(other.address)) {
+    other.pool = nullptr;
+}
+
+HttpConnection::~HttpConnection() {
+    if (pool) {
+        pool->Release(key, std::move(client), reusable, connect_failed, std::move(address));
+    }
+}
+
+// Split fractional seconds into the (seconds, microseconds) httplib takes
+static std::pair<time_t, time_t> SplitTimeout(double seconds) {
+    auto micros = static_cast<int64_t>(seconds * 1000000);
+    return std::make_pair(static_cast<time_t>(micros / 1000000), static_cast<time_t>(micros % 1000000));
+}
+
+static void ConfigureClient(duckdb_httplib_openssl::Client &client, const HttpClientSettings &settings) {
+    client.set_keep_alive(settings.keep_alive);
+    auto connect_timeout = SplitTimeout(settings.connect_timeout);
+    client.set_connection_timeout(connect_timeout.first, connect_timeout.second);
+    auto read_timeout = SplitTimeout(settings.read_timeout);
+    client.set_read_timeout(read_timeout.first, read_timeout.second);
+    auto write_timeout = SplitTimeout(settings.write_timeout);
+    client.set_write_timeout(write_timeout.first, write_timeout.second);
+    client.set_follow_location(true); // Follow redirects
+}
+
+void HttpConnectionPool::HostPool::Configure(const HttpEndpoint &endpoint_p, const HttpClientSettings &settings) {
+    host = endpoint_p.host;
+    keep_alive = settings.keep_alive;
+    idle_timeout = settings.pool_idle_timeout;
+    max_connections = settings.max_connections_per_host;
+    adaptive = settings.adaptive_concurrency;
+    if (limit == 0) {
+        limit = static_cast<double>(max_connections);
+    }
+}
+
+HttpConnection HttpConnectionPool::Acquire(const HttpEndpoint &endpoint, const HttpClientSettings &settings) {
+    auto key = endpoint.ToString();
+    Reservation reservation;
+    Reserve(key, endpoint, settings, true, reservation);
+    return Lease(std::move(key), endpoint, settings, std::move(reservation));
+}
+
+bool HttpConnectionPool::Reserve(const std::string &key, const HttpEndpoint &endpoint,
+                                 const HttpClientSettings &settings, bool wait, Reservation &reservation) {
+    vector<EvictedConnection> evicted;
+    bool reserved = false;
+    bool stopped = false;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        auto &host = hosts[key];
+        host.Configure(endpoint, settings);
+        EvictIdle(Clock::now(), evicted);
+
+        // The destructor joins the heartbeat thread, nothing may go on waiting for a slot once it runs
+        auto available = [&]() { return shutdown || host.active < host.ActiveLimit(); };
+        if (wait) {
+            released.wait(guard, available);
+        }
+        stopped = shutdown;
+        if (!stopped && available()) {
+            if (!host.idle.empty()) {
+                // Most recently returned first, it is the least likely to have been closed by the server
+                reservation.client = std::move(host.idle.back().client);
+                reservation.address = std::move(host.idle.back().address);
+                host.idle.pop_back();
+                reservation.connected = true;
+            } else if (!host.closed.empty()) {
+                // Reconnects on first use
+                reservation.client = std::move(host.closed.back());
+                host.closed.pop_back();
+            }
+            host.active++;
+            reserved = true;
+        }
+    }
+    // Close evicted connections without holding the lock
+    KeepClosed(evicted);
+    if (stopped && wait) {
+        throw std::runtime_error("HTTP connection pool is shutting down");
+    }
+    return reserved;
+}
+
+HttpConnection HttpConnectionPool::Lease(std::string key, const HttpEndpoint &endpoint,
+                                         const HttpClientSettings &settings, Reservation reservation) {
+    auto &client = reservation.client;
+    auto &address = reservation.address;
+    auto connected = reservation.connected;
+    if (!client) {
+        client = make_uniq<duckdb_httplib_openssl::Client>(key);
+    }
+    double resolve_ms = 0;
+    if (!connected) {
+        // Connect to the cached address; the host name is still what goes into the Host header and SNI
+        auto resolve_start = Clock::now();
+        address = dns.Resolve(endpoint.host, settings);
+        resolve_ms = std::chrono::duration<double, std::milli>(Clock::now() - resolve_start).count();
+        std::map<std::string, std::string> addresses;
+        if (!address.empty()) {
+            addresses[endpoint.host] = address;
+        }
+        client->set_hostname_addr_map(std::move(addresses));
+    }
+    ConfigureClient(*client, settings);
+    HttpConnection connection(*this, std::move(key), std::move(client));
+    connection.reused = connected;
+    connection.resolve_ms = resolve_ms;
+    connection.address = std::move(address);
+    return connection;
+}
+
+void HttpConnectionPool::Release(const std::string &key, unique_ptr<duckdb_httplib_openssl::Client> client,
+                                 bool reusable, bool connect_failed, std::string address) {
+    vector<EvictedConnection> closed;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &host = hosts[key];
+        host.active--;
+        if (client && reusable && host.keep_alive) {
+            host.idle.push_back(IdleConnection {std::move(client), Clock::now(), address});
+        } else if (client) {
+            closed.emplace_back(key, std::move(client));
+        }
+        if (connect_failed) {
+            // The address may be what failed, the next connection tries the host's next one
+            dns.Failed(host.host, address);
+        }
+    }
+    released.notify_all();
+    // A connection that was not pooled is closed here, outside the lock
+    KeepClosed(closed);
+}
+
+void HttpConnection::ReportOutcome(bool overloaded, double latency_ms) {
+    if (pool) {
+        pool->RecordOutcome(key, overloaded, latency_ms);
+    }
+}
+
+void HttpConnectionPool::RecordOutcome(const std::string &key, bool overloaded, double latency_ms) {
+    bool raised = false;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &host = hosts[key];
+        auto average = host.latency_ms;
+        host.latency_ms = average == 0 ? latency_ms : 0.9 * average + 0.1 * latency_ms;
+        if (overloaded) {
+            host.overloads++;
+        } else {
+            host.successes++;
+        }
+        if (!host.adaptive) {
+            return;
+        }
+
+        auto now = Clock::now();
+        if (overloaded) {
+            // Halve at most once per round trip, the other requests in flight have seen the same overload
+            if (now - host.last_decrease >= std::chrono::duration<double, std::milli>(average)) {
+                host.limit = MaxValue<double>(host.limit / 2, 1);
+                host.last_decrease = now;
+            }
+        } else if (average == 0 || latency_ms < 2 * average) {
+            // Grow by one connection per limit's worth of successes, as long as latency is not climbing
+            auto previous = host.ActiveLimit();
+            host.limit = MinValue<double>(host.limit + 1 / host.limit, static_cast<double>(host.max_connections));
+            raised = host.ActiveLimit() > previous;
+        }
+    }
+    if (raised) {
+        released.notify_all();
+    }
+}
+
+vector<HttpHostStats> HttpConnectionPool::GetHostStats() {
+    vector<HttpHostStats> result;
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &entry : hosts) {
+        auto &host = entry.second;
+        HttpHostStats stats;
+        stats.host = entry.first;
+        stats.active = host.active;
+        stats.idle = host.idle.size();
+        stats.limit = host.ActiveLimit();
+        stats.latency_ms = host.latency_ms;
+        stats.successes = host.successes;
+        stats.overloads = host.overloads;
+        stats.pinned = host.pinned;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void HttpConnectionPool::EvictIdle(Clock::time_point now, vector<EvictedConnection> &evicted) {
+    for (auto &entry : hosts) {
+        auto &host = entry.second;
+        auto timeout = std::chrono::seconds(host.idle_timeout);
+        // Returned connections are appended, so the oldest idle ones sit at the front; the pinned ones are kept
+        while (host.idle.size() > host.pinned && now - host.idle.front().idle_since >= timeout) {
+            evicted.emplace_back(entry.first, std::move(host.idle.front().client));
+            host.idle.pop_front();
+        }
+    }
+}
+
+void HttpConnectionPool::KeepClosed(vector<EvictedConnection> &evicted) {
+    if (evicted.empty()) {
+        return;
+    }
+    for (auto &connection : evicted) {
+        connection.second->stop();
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &connection : evicted) {
+        auto &host = hosts[connection.first];
+        // Never keep more clients around than the host may have connections, the rest are destroyed
+        if (host.closed.size() + host.idle.size() < host.max_connections) {
+            host.closed.push_back(std::move(connection.second));
+        }
+    }
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        shutdown = true;
+        for (auto client : pinging) {
+            client->stop();
+        }
+    }
+    heartbeat_changed.notify_all();
+    released.notify_all();
+    if (heartbeat.joinable()) {
+        heartbeat.join();
+    }
+}
+
+idx_t HttpConnectionPool::Prewarm(const HttpEndpoint &endpoint, const HttpClientSettings &settings,
+                                  idx_t connections, std::string &error) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &host = hosts[endpoint.ToString()];
+        // No more than may be leased at once, an adaptive limit shrinks what is pinned too
+        host.Configure(endpoint, settings);
+        connections = MinValue<idx_t>(connections, host.ActiveLimit());
+        host.pinned = connections;
+        host.endpoint = endpoint;
+        host.pin_settings = settings;
+        // The heartbeat outlives the query that pinned the host
+        host.pin_settings.interrupted = nullptr;
+        heartbeat_interval = settings.heartbeat_interval;
+        if (connections > 0 && !heartbeat_started) {
+            heartbeat_started = true;
+            try {
+                heartbeat = std::thread([this]() { HeartbeatLoop(); });
+            } catch (std::system_error &) {
+                // Without the thread pinned connections are still kept, until the server closes them
+            }
+        }
+    }
+    heartbeat_changed.notify_all();
+    return OpenConnections(endpoint, settings, connections, error);
+}
+
+idx_t HttpConnectionPool::OpenConnections(const HttpEndpoint &endpoint, const HttpClientSettings &settings,
+                                          idx_t connections, std::string &error) {
+    // Holding all leases at once makes every one of them a connection of its own. They are only taken while
+    // the host has slots free: waiting for one while holding others could wait on itself, or on requests that
+    // wait for these.
+    auto key = endpoint.ToString();
+    vector<HttpConnection> leases;
+    for (idx_t i = 0; i < connections; i++) {
+        Reservation reservation;
+        if (!Reserve(key, endpoint, settings, false, reservation)) {
+            break;
+        }
+        leases.push_back(Lease(key, endpoint, settings, std::move(reservation)));
+    }
+    idx_t established = 0;
+    for (auto &connection : leases) {
+        if (Ping(connection, error)) {
+            established++;
+        }
+    }
+    return established;
+}
+
+// A HEAD request for "/" establishes the connection (TCP and TLS) if it is not open, or finds out that the server
+// closed it and reconnects. Whatever the status, a response means the connection is open.
+bool HttpConnectionPool::Ping(HttpConnection &connection, std::string &error) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (shutdown) {
+            return false;
+        }
+        pinging.insert(&*connection);
+    }
+    // Reconfigured on its next lease
+    connection->set_follow_location(false);
+    auto res = connection->Head("/");
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pinging.erase(&*connection);
+    }
+    if (!res) {
+        connection.Invalidate(res.error());
+        error = "Could not connect to " + connection.Key() + ": " + duckdb_httplib_openssl::to_string(res.error());
+        return false;
+    }
+    return true;
+}
+
+void HttpConnectionPool::HeartbeatLoop() {
+    struct PinnedHost {
+        HttpEndpoint endpoint;
+        HttpClientSettings settings;
+        idx_t connections;
+    };
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (!shutdown) {
+        if (heartbeat_interval == 0) {
+            heartbeat_changed.wait(guard, [&]() { return shutdown || heartbeat_interval > 0; });
+            continue;
+        }
+        // A changed interval starts the wait over
+        auto interval = heartbeat_interval;
+        if (heartbeat_changed.wait_for(guard, std::chrono::seconds(interval),
+                                       [&]() { return shutdown || heartbeat_interval != interval; })) {
+            continue;
+        }
+        // Hosts with connections in use are kept warm by their requests
+        vector<PinnedHost> pinned;
+        for (auto &entry : hosts) {
+            auto &host = entry.second;
+            if (host.pinned > 0 && host.active == 0) {
+                pinned.push_back(PinnedHost {host.endpoint, host.pin_settings, host.pinned});
+            }
+        }
+        guard.unlock();
+        for (auto &host : pinned) {
+            // A connection that cannot be opened is tried again on the next heartbeat
+            std::string error;
+            OpenConnections(host.endpoint, host.settings, host.connections, error);
+        }
+        guard.lock();
+    }
+}
+
+void HttpConnectionPool::Clear() {
+    vector<unique_ptr<duckdb_httplib_openssl::Client>> evicted;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto &entry : hosts) {
+            for (auto &idle : entry.second.idle) {
+                evicted.push_back(std::move(idle.client));
+            }
+            for (auto &closed : entry.second.closed) {
+                evicted.push_back(std::move(closed));
+            }
+            entry.second.idle.clear();
+            entry.second.closed.clear();
+        }
+    }
+    dns.Clear();
+}
+
+} // namespace duckdb
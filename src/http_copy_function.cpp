@@ -0,0 +1,430 @@
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/function/copy_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+#include "http_request.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace duckdb {
+
+//! Bytes of formatted rows buffered ahead of an upload, the sink waits once this much has not been sent yet
+static constexpr idx_t HTTP_UPLOAD_BUFFER_SIZE = 8 * 1024 * 1024;
+
+struct HttpCopyBindData : public FunctionData {
+    std::string url;
+    duckdb_httplib_openssl::Headers headers;
+    //! CSV instead of NDJSON
+    bool csv = false;
+    //! Whether every CSV upload starts with a line of column names
+    bool csv_header = true;
+    char delimiter = ',';
+    //! Per column: the JSON object key ("\"name\":"), CSV uses the plain names
+    vector<std::string> json_keys;
+    vector<std::string> names;
+    vector<LogicalType> types;
+
+    unique_ptr<FunctionData> Copy() const override {
+        auto result = make_uniq<HttpCopyBindData>();
+        *result = *this;
+        return std::move(result);
+    }
+    bool Equals(const FunctionData &other_p) const override {
+        auto &other = other_p.Cast<HttpCopyBindData>();
+        return url == other.url && csv == other.csv && names == other.names;
+    }
+};
+
+//! Formatted rows handed from the sink to the thread sending them
+struct HttpUploadStream {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::string> pieces;
+    //! Bytes in pieces
+    idx_t buffered = 0;
+    //! Set by the sink once all rows were pushed
+    bool closed = false;
+    //! Set when the sink goes away without closing, the upload is then aborted
+    bool cancelled = false;
+    //! Set by the sender once the request is over, successfully or not
+    bool done = false;
+    std::atomic<bool> aborted {false};
+    std::string error;
+
+    //! Queue formatted rows, waiting while the upload is behind; returns false once the upload is over
+    bool Push(std::string piece, const std::atomic<bool> &interrupted) {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!changed.wait_for(guard, std::chrono::milliseconds(100),
+                                 [&]() { return done || buffered < HTTP_UPLOAD_BUFFER_SIZE; })) {
+            if (interrupted) {
+                throw InterruptException();
+            }
+        }
+        if (done) {
+            return false;
+        }
+        buffered += piece.size();
+        pieces.push_back(std::move(piece));
+        changed.notify_all();
+        return true;
+    }
+
+    //! Take the next piece for the request body; false when there is none because the sink closed or went away
+    bool Pop(std::string &piece) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return cancelled || closed || !pieces.empty(); });
+        if (cancelled || pieces.empty()) {
+            return false;
+        }
+        piece = std::move(pieces.front());
+        pieces.pop_front();
+        buffered -= piece.size();
+        changed.notify_all();
+        return true;
+    }
+
+    void Finish(std::string error_p) {
+        std::lock_guard<std::mutex> guard(lock);
+        done = true;
+        error = std::move(error_p);
+        changed.notify_all();
+    }
+};
+
+struct HttpCopyGlobalState : public GlobalFunctionData {
+};
+
+//! One upload per sink: the only one for an ordered COPY, one per thread otherwise
+struct HttpCopyLocalState : public LocalFunctionData {
+    ~HttpCopyLocalState() override {
+        if (!stream) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(stream->lock);
+            stream->cancelled = true;
+        }
+        stream->aborted = true;
+        stream->changed.notify_all();
+        if (sender.joinable()) {
+            sender.join();
+        }
+    }
+
+    shared_ptr<HttpClientState> client_state;
+    HttpClientSettings settings;
+    //! Null until the first rows arrive, a sink without rows sends nothing
+    shared_ptr<HttpUploadStream> stream;
+    std::thread sender;
+};
+
+static std::string JsonQuote(const char *data, idx_t length) {
+    std::string result;
+    result.reserve(length + 2);
+    result += '"';
+    for (idx_t i = 0; i < length; i++) {
+        auto c = static_cast<unsigned char>(data[i]);
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                result += escaped;
+            } else {
+                result += static_cast<char>(c);
+            }
+        }
+    }
+    result += '"';
+    return result;
+}
+
+// Numbers and booleans are written as JSON literals, everything else as their text in a string
+static bool IsJsonLiteral(const LogicalType &type) {
+    return type.IsNumeric() || type.id() == LogicalTypeId::BOOLEAN;
+}
+
+static void AppendCsvField(std::string &out, const char *data, idx_t length, char delimiter) {
+    bool quote = false;
+    for (idx_t i = 0; i < length && !quote; i++) {
+        quote = data[i] == delimiter || data[i] == '"' || data[i] == '\n' || data[i] == '\r';
+    }
+    if (!quote) {
+        out.append(data, length);
+        return;
+    }
+    out += '"';
+    for (idx_t i = 0; i < length; i++) {
+        if (data[i] == '"') {
+            out += '"';
+        }
+        out += data[i];
+    }
+    out += '"';
+}
+
+static unique_ptr<FunctionData> HttpCopyBind(ClientContext &context, CopyFunctionBindInput &input,
+                                             const vector<string> &names, const vector<LogicalType> &sql_types) {
+    auto result = make_uniq<HttpCopyBindData>();
+    result->url = input.info.file_path;
+    for (auto &option : input.info.options) {
+        auto name = StringUtil::Lower(option.first);
+        auto &values = option.second;
+        if (name == "body_format") {
+            auto format = values.empty() ? std::string() : StringUtil::Lower(values[0].ToString());
+            if (format != "ndjson" && format != "csv") {
+                throw BinderException("COPY TO http: BODY_FORMAT must be 'ndjson' or 'csv'");
+            }
+            result->csv = format == "csv";
+        } else if (name == "headers") {
+            if (!values.empty()) {
+                result->headers = HttpHeadersFromValue(values[0]);
+            }
+        } else if (name == "header") {
+            result->csv_header = values.empty() || BooleanValue::Get(values[0].DefaultCastAs(LogicalType::BOOLEAN));
+        } else if (name == "delimiter" || name == "delim" || name == "sep") {
+            auto delimiter = values.empty() ? std::string() : values[0].ToString();
+            if (delimiter.size() != 1) {
+                throw BinderException("COPY TO http: DELIMITER must be a single character");
+            }
+            result->delimiter = delimiter[0];
+        } else {
+            throw BinderException("Unrecognized option for COPY TO http: %s", option.first);
+        }
+    }
+    for (auto &column : names) {
+        result->json_keys.push_back(JsonQuote(column.data(), column.size()) + ":");
+    }
+    result->names = names;
+    result->types = sql_types;
+    return std::move(result);
+}
+
+static unique_ptr<GlobalFunctionData> HttpCopyInitializeGlobal(ClientContext &context, FunctionData &bind_data,
+                                                               const string &file_path) {
+    return make_uniq<HttpCopyGlobalState>();
+}
+
+static unique_ptr<LocalFunctionData> HttpCopyInitializeLocal(ExecutionContext &context, FunctionData &bind_data) {
+    auto result = make_uniq<HttpCopyLocalState>();
+    result->client_state = HttpClientState::Get(context.client);
+    result->settings = HttpClientSettings::Get(context.client);
+    return std::move(result);
+}
+
+// Runs on the sender thread: one POST whose body is streamed from the sink as it formats rows
+static void SendHttpUpload(shared_ptr<HttpClientState> client_state, HttpClientSettings settings,
+                           HttpRequest request, shared_ptr<HttpUploadStream> stream) {
+    std::string error;
+    try {
+        auto &metrics = *request.endpoint->metrics;
+        std::string piece;
+        request.body_provider = [&](size_t, duckdb_httplib_openssl::DataSink &sink) {
+            if (!stream->Pop(piece)) {
+                std::lock_guard<std::mutex> guard(stream->lock);
+                if (stream->cancelled) {
+                    return false;
+                }
+                sink.done();
+                return true;
+            }
+            metrics.bytes_sent.fetch_add(piece.size(), std::memory_order_relaxed);
+            return sink.write(piece.data(), piece.size());
+        };
+        auto response = StreamHttpRequest(*client_state, settings, request, nullptr,
+                                          [](const char *, idx_t) { return true; });
+        if (!response.received) {
+            error = response.error;
+        } else if (response.status < 200 || response.status >= 300) {
+            error = "HTTP POST error: " + std::to_string(response.status) + " - " + response.reason;
+        }
+    } catch (std::exception &ex) {
+        error = ex.what();
+    }
+    stream->Finish(std::move(error));
+}
+
+static void StartHttpUpload(ClientContext &context, const HttpCopyBindData &bind_data, HttpCopyLocalState &state) {
+    state.stream = make_shared_ptr<HttpUploadStream>();
+    state.settings.interrupted = &state.stream->aborted;
+
+    HttpRequest request;
+    request.method = "POST";
+    request.url = bind_data.url;
+    request.headers = bind_data.headers;
+    request.content_type = bind_data.csv ? "text/csv" : "application/x-ndjson";
+    HttpUrlResolver(state.settings, &state.client_state->metrics).Resolve(request);
+    try {
+        state.sender = std::thread(SendHttpUpload, state.client_state, state.settings, std::move(request), state.stream);
+    } catch (std::system_error &ex) {
+        throw std::runtime_error(std::string("COPY TO http could not start its sending thread: ") + ex.what());
+    }
+
+    if (bind_data.csv && bind_data.csv_header) {
+        std::string header;
+        for (idx_t col = 0; col < bind_data.names.size(); col++) {
+            if (col > 0) {
+                header += bind_data.delimiter;
+            }
+            AppendCsvField(header, bind_data.names[col].data(), bind_data.names[col].size(), bind_data.delimiter);
+        }
+        header += '\n';
+        state.stream->Push(std::move(header), context.interrupted);
+    }
+}
+
+// Throw the error the upload ended with, if any
+static void CheckHttpUpload(HttpUploadStream &stream) {
+    std::lock_guard<std::mutex> guard(stream.lock);
+    if (stream.done && !stream.error.empty()) {
+        throw std::runtime_error(stream.error);
+    }
+}
+
+static void HttpCopySink(ExecutionContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate,
+                         LocalFunctionData &lstate, DataChunk &input) {
+    auto &bind_data = bind_data_p.Cast<HttpCopyBindData>();
+    auto &state = lstate.Cast<HttpCopyLocalState>();
+    if (context.client.interrupted) {
+        throw InterruptException();
+    }
+    auto count = input.size();
+    if (count == 0) {
+        // An empty piece would read as the end of a chunked body
+        return;
+    }
+    if (!state.stream) {
+        StartHttpUpload(context.client, bind_data, state);
+    }
+
+    // Every column as text, the way DuckDB casts it to VARCHAR
+    vector<Vector> text;
+    text.reserve(input.ColumnCount());
+    vector<UnifiedVectorFormat> formats(input.ColumnCount());
+    for (idx_t col = 0; col < input.ColumnCount(); col++) {
+        if (input.data[col].GetType().id() == LogicalTypeId::VARCHAR) {
+            text.emplace_back(input.data[col]);
+        } else {
+            text.emplace_back(LogicalType::VARCHAR, count);
+            VectorOperations::DefaultCast(input.data[col], text.back(), count);
+        }
+        text.back().ToUnifiedFormat(count, formats[col]);
+    }
+
+    std::string piece;
+    for (idx_t row = 0; row < count; row++) {
+        if (!bind_data.csv) {
+            piece += '{';
+        }
+        for (idx_t col = 0; col < formats.size(); col++) {
+            auto &format = formats[col];
+            auto index = format.sel->get_index(row);
+            auto valid = format.validity.RowIsValid(index);
+            auto &value = UnifiedVectorFormat::GetData<string_t>(format)[index];
+            if (bind_data.csv) {
+                if (col > 0) {
+                    piece += bind_data.delimiter;
+                }
+                if (valid) {
+                    AppendCsvField(piece, value.GetData(), value.GetSize(), bind_data.delimiter);
+                }
+                continue;
+            }
+            if (col > 0) {
+                piece += ',';
+            }
+            piece += bind_data.json_keys[col];
+            if (!valid) {
+                piece += "null";
+            } else if (IsJsonLiteral(bind_data.types[col])) {
+                auto literal = value.GetString();
+                // JSON has no infinity or NaN
+                piece += literal == "inf" || literal == "-inf" || literal == "nan" ? "null" : literal;
+            } else {
+                piece += JsonQuote(value.GetData(), value.GetSize());
+            }
+        }
+        piece += bind_data.csv ? "\n" : "}\n";
+    }
+    if (!state.stream->Push(std::move(piece), context.client.interrupted)) {
+        CheckHttpUpload(*state.stream);
+        throw std::runtime_error("COPY TO http: the upload ended before all rows were sent");
+    }
+}
+
+// All rows of this sink were pushed: end the body and wait for the response
+static void HttpCopyCombine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                            LocalFunctionData &lstate) {
+    auto &state = lstate.Cast<HttpCopyLocalState>();
+    if (!state.stream) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(state.stream->lock);
+        state.stream->closed = true;
+    }
+    state.stream->changed.notify_all();
+    {
+        std::unique_lock<std::mutex> guard(state.stream->lock);
+        while (!state.stream->changed.wait_for(guard, std::chrono::milliseconds(100),
+                                               [&]() { return state.stream->done; })) {
+            if (context.client.interrupted) {
+                // The local state aborts the upload when it is destroyed
+                throw InterruptException();
+            }
+        }
+    }
+    state.sender.join();
+    CheckHttpUpload(*state.stream);
+}
+
+static void HttpCopyFinalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+}
+
+// An ordered COPY streams everything through one upload, otherwise every thread uploads its rows on its own
+static CopyFunctionExecutionMode HttpCopyExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+    return preserve_insertion_order ? CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE
+                                    : CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+}
+
+void HTTPFunctions::RegisterHTTPCopyFunction(DatabaseInstance &instance) {
+    CopyFunction function("http");
+    function.copy_to_bind = HttpCopyBind;
+    function.copy_to_initialize_global = HttpCopyInitializeGlobal;
+    function.copy_to_initialize_local = HttpCopyInitializeLocal;
+    function.copy_to_sink = HttpCopySink;
+    function.copy_to_combine = HttpCopyCombine;
+    function.copy_to_finalize = HttpCopyFinalize;
+    function.execution_mode = HttpCopyExecutionMode;
+    ExtensionUtil::RegisterFunction(instance, function);
+}
+
+} // namespace duckdb
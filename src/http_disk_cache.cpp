@@ -0,0 +1,311 @@
+#include "http_disk_cache.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "http_response_cache.hpp"
+
+#include <openssl/sha.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace duckdb {
+
+static constexpr uint32_t RECORD_MAGIC = 0x32435448; // "HTC2"
+//! Appends go to a new segment once the current one reaches this size, eviction drops whole segments
+static constexpr idx_t SEGMENT_SIZE = 64 * 1024 * 1024;
+static constexpr const char *SEGMENT_PREFIX = "segment-";
+static constexpr const char *SEGMENT_SUFFIX = ".httpcache";
+
+namespace {
+
+//! Fixed-size header of a record, followed by the key digest, reason, serialized headers and body
+struct RecordHeader {
+    uint32_t magic;
+    int32_t status;
+    int64_t stored_at;
+    int64_t expires_at;
+    uint64_t key_length;
+    uint64_t reason_length;
+    uint64_t headers_length;
+    uint64_t body_length;
+
+    idx_t TotalLength() const {
+        return sizeof(RecordHeader) + key_length + reason_length + headers_length + body_length;
+    }
+};
+
+} // namespace
+
+static int64_t UnixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// The key holds the request headers and body, only its digest is written to disk
+static std::string DigestKey(const std::string &key) {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char *>(key.data()), key.size(), digest);
+    return std::string(reinterpret_cast<const char *>(digest), SHA256_DIGEST_LENGTH);
+}
+
+static std::string SerializeHeaders(const duckdb_httplib_openssl::Headers &headers) {
+    std::string result;
+    for (auto &header : headers) {
+        result += header.first + ": " + header.second + "\r\n";
+    }
+    return result;
+}
+
+static duckdb_httplib_openssl::Headers DeserializeHeaders(const std::string &data) {
+    duckdb_httplib_openssl::Headers headers;
+    size_t start = 0;
+    while (start < data.size()) {
+        auto end = data.find("\r\n", start);
+        if (end == std::string::npos) {
+            end = data.size();
+        }
+        auto separator = data.find(": ", start);
+        if (separator != std::string::npos && separator < end) {
+            headers.emplace(data.substr(start, separator - start), data.substr(separator + 2, end - separator - 2));
+        }
+        start = end + 2;
+    }
+    return headers;
+}
+
+shared_ptr<HttpDiskCache::Segment> HttpDiskCache::OpenSegment(idx_t id, bool create) {
+    auto number = std::to_string(id);
+    number.insert(0, number.size() < 8 ? 8 - number.size() : 0, '0');
+
+    auto segment = make_shared_ptr<Segment>();
+    segment->id = id;
+    segment->path = fs->JoinPath(directory, SEGMENT_PREFIX + number + SEGMENT_SUFFIX);
+    FileOpenFlags flags = FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_WRITE;
+    if (create) {
+        flags = flags | FileFlags::FILE_FLAGS_FILE_CREATE;
+    }
+    segment->handle = fs->OpenFile(segment->path, flags);
+    return segment;
+}
+
+void HttpDiskCache::ScanSegment(const shared_ptr<Segment> &segment_ptr) {
+    auto &segment = *segment_ptr;
+    auto file_size = static_cast<idx_t>(segment.handle->GetFileSize());
+    idx_t offset = 0;
+    while (offset + sizeof(RecordHeader) <= file_size) {
+        RecordHeader header;
+        segment.handle->Read(&header, sizeof(RecordHeader), offset);
+        auto remaining = file_size - offset;
+        if (header.magic != RECORD_MAGIC || header.key_length > remaining || header.reason_length > remaining ||
+            header.headers_length > remaining || header.body_length > remaining ||
+            header.TotalLength() > remaining) {
+            // A torn write at the end of the segment, the next append overwrites it
+            break;
+        }
+        std::string digest(header.key_length, '\0');
+        segment.handle->Read(&digest[0], header.key_length, offset + sizeof(RecordHeader));
+
+        auto length = header.TotalLength();
+        index[digest] = Location {segment_ptr, offset, length, header.stored_at, header.expires_at};
+        offset += length;
+    }
+    if (offset == 0 && file_size > 0) {
+        // Written before keys were stored as digests; drop it rather than keep request headers around
+        segment.handle->Truncate(0);
+    }
+    segment.size = offset;
+}
+
+void HttpDiskCache::Configure(const HttpClientSettings &settings) {
+    if (settings.cache_path == directory) {
+        return;
+    }
+    segments.clear();
+    index.clear();
+    total_size = 0;
+    directory = settings.cache_path;
+    if (directory.empty()) {
+        return;
+    }
+
+    if (!fs) {
+        fs = FileSystem::CreateLocal();
+    }
+    if (!fs->DirectoryExists(directory)) {
+        fs->CreateDirectory(directory);
+    }
+
+    vector<idx_t> ids;
+    std::string prefix = SEGMENT_PREFIX;
+    std::string suffix = SEGMENT_SUFFIX;
+    fs->ListFiles(directory, [&](const std::string &name, bool is_directory) {
+        if (is_directory || name.size() <= prefix.size() + suffix.size() || !StringUtil::StartsWith(name, prefix) ||
+            !StringUtil::EndsWith(name, suffix)) {
+            return;
+        }
+        auto number = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        if (number.size() <= 18 && number.find_first_not_of("0123456789") == std::string::npos) {
+            ids.push_back(std::stoull(number));
+        }
+    });
+    std::sort(ids.begin(), ids.end());
+
+    // Later segments are newer, scanning in order lets newer records of a key override older ones
+    for (auto id : ids) {
+        auto segment = OpenSegment(id, false);
+        segments[id] = segment;
+        ScanSegment(segment);
+        total_size += segment->size;
+    }
+    EvictUntil(settings.disk_cache_size);
+}
+
+bool HttpDiskCache::Lookup(const HttpClientSettings &settings, const std::string &key, HttpResponse &response) {
+    auto digest = DigestKey(key);
+    Location location;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Configure(settings);
+        if (directory.empty()) {
+            return false;
+        }
+        auto entry = index.find(digest);
+        if (entry == index.end()) {
+            misses++;
+            return false;
+        }
+        location = entry->second;
+    }
+    // Stale entries are not revalidated from here, the response is fetched again (and stored anew)
+    auto now = UnixNow();
+    if (now >= location.expires_at ||
+        (settings.disk_cache_ttl > 0 && now - location.stored_at > static_cast<int64_t>(settings.disk_cache_ttl))) {
+        misses++;
+        return false;
+    }
+
+    // The segment stays open while we hold it, even if it is evicted in the meantime
+    std::string record(location.length, '\0');
+    location.segment->handle->Read(&record[0], location.length, location.offset);
+    RecordHeader header;
+    memcpy(&header, record.data(), sizeof(RecordHeader));
+    auto data = record.data() + sizeof(RecordHeader);
+    if (header.magic != RECORD_MAGIC || header.TotalLength() != location.length ||
+        std::string(data, header.key_length) != digest) {
+        // A record that was overwritten
+        misses++;
+        return false;
+    }
+    data += header.key_length;
+
+    response = HttpResponse();
+    response.received = true;
+    response.status = header.status;
+    response.reason = std::string(data, header.reason_length);
+    data += header.reason_length;
+    response.headers = DeserializeHeaders(std::string(data, header.headers_length));
+    data += header.headers_length;
+    response.body = std::string(data, header.body_length);
+    hits++;
+    return true;
+}
+
+void HttpDiskCache::Store(const HttpClientSettings &settings, const std::string &key, const HttpResponse &response) {
+    if (!response.received || response.status != 200) {
+        return;
+    }
+    // Fresh for as long as the in-memory cache would serve it without revalidation, which the disk cache does not do
+    int64_t lifetime;
+    if (!HttpResponseCache::StorableLifetime(response.headers, lifetime) || lifetime == 0) {
+        return;
+    }
+
+    // Everything but the body goes into one buffer, the body is written from the response itself
+    auto digest = DigestKey(key);
+    auto serialized_headers = SerializeHeaders(response.headers);
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.status = response.status;
+    header.stored_at = UnixNow();
+    header.expires_at = header.stored_at + lifetime;
+    header.key_length = digest.size();
+    header.reason_length = response.reason.size();
+    header.headers_length = serialized_headers.size();
+    header.body_length = response.body.size();
+
+    std::string prefix;
+    prefix.reserve(header.TotalLength() - header.body_length);
+    prefix.append(reinterpret_cast<const char *>(&header), sizeof(RecordHeader));
+    prefix += digest;
+    prefix += response.reason;
+    prefix += serialized_headers;
+    auto length = header.TotalLength();
+
+    // Reserve room at the end of the active segment under the lock, write outside of it, then index the record
+    shared_ptr<Segment> active;
+    idx_t offset;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Configure(settings);
+        if (directory.empty() || length > settings.disk_cache_size) {
+            return;
+        }
+        if (!segments.empty()) {
+            active = segments.rbegin()->second;
+        }
+        if (!active || active->size >= SEGMENT_SIZE) {
+            auto id = active ? active->id + 1 : 0;
+            active = OpenSegment(id, true);
+            segments[id] = active;
+        }
+        offset = active->size;
+        active->size += length;
+        total_size += length;
+    }
+
+    active->handle->Write(&prefix[0], prefix.size(), offset);
+    if (!response.body.empty()) {
+        active->handle->Write(const_cast<char *>(response.body.data()), response.body.size(), offset + prefix.size());
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto segment = segments.find(active->id);
+    if (segment == segments.end() || segment->second != active) {
+        // Evicted (or the directory changed) while the record was written
+        return;
+    }
+    index[digest] = Location {active, offset, length, header.stored_at, header.expires_at};
+    EvictUntil(settings.disk_cache_size);
+}
+
+void HttpDiskCache::EvictUntil(idx_t max_size) {
+    while (total_size > max_size && !segments.empty()) {
+        auto oldest = segments.begin()->second;
+        segments.erase(segments.begin());
+        total_size -= oldest->size;
+        for (auto it = index.begin(); it != index.end();) {
+            if (it->second.segment == oldest) {
+                it = index.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        try {
+            fs->RemoveFile(oldest->path);
+        } catch (std::exception &) {
+            // Still open elsewhere (e.g. on Windows), it is no longer indexed and is evicted again on the next open
+        }
+    }
+}
+
+HttpDiskCacheStats HttpDiskCache::GetStats() {
+    HttpDiskCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    std::lock_guard<std::mutex> guard(lock);
+    stats.entries = index.size();
+    stats.size = total_size;
+    return stats;
+}
+
+} // namespace duckdb
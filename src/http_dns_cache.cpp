@@ -0,0 +1,99 @@
+#include "http_dns_cache.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+static bool IsAddressLiteral(const std::string &host) {
+    // IPv6 literals contain colons and never need resolving, IPv4 ones only consist of digits and dots
+    return host.find(':') != std::string::npos || host.find_first_not_of("0123456789.") == std::string::npos;
+}
+
+// Ask the system resolver, returns the addresses in its (RFC 6724) preference order
+static vector<std::string> LookupAddresses(const std::string &host) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    vector<std::string> addresses;
+    struct addrinfo *result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0) {
+        return addresses;
+    }
+    for (auto info = result; info; info = info->ai_next) {
+        char address[NI_MAXHOST];
+        if (getnameinfo(info->ai_addr, static_cast<socklen_t>(info->ai_addrlen), address, sizeof(address), nullptr, 0,
+                        NI_NUMERICHOST) == 0 &&
+            std::find(addresses.begin(), addresses.end(), address) == addresses.end()) {
+            addresses.emplace_back(address);
+        }
+    }
+    freeaddrinfo(result);
+    return addresses;
+}
+
+std::string HttpDnsCache::Resolve(const std::string &host, const HttpClientSettings &settings) {
+    auto override_entry = settings.dns_overrides.find(StringUtil::Lower(host));
+    if (override_entry != settings.dns_overrides.end()) {
+        return override_entry->second;
+    }
+    if (settings.dns_cache_ttl == 0 || IsAddressLiteral(host)) {
+        return std::string();
+    }
+
+    auto now = Clock::now();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto entry = entries.find(host);
+        if (entry != entries.end() && entry->second.expires > now) {
+            return entry->second.addresses[entry->second.current];
+        }
+    }
+
+    // Resolve without holding the lock, a slow resolver must not hold up connections to other hosts
+    auto addresses = LookupAddresses(host);
+    if (addresses.empty()) {
+        return std::string();
+    }
+    auto address = addresses[0];
+    std::lock_guard<std::mutex> guard(lock);
+    auto &entry = entries[host];
+    entry = Entry();
+    entry.addresses = std::move(addresses);
+    entry.expires = now + std::chrono::seconds(settings.dns_cache_ttl);
+    return address;
+}
+
+void HttpDnsCache::Failed(const std::string &host, const std::string &address) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto entry = entries.find(host);
+    // Only the first of several connections failing on the same address moves on
+    if (entry == entries.end() || entry->second.addresses[entry->second.current] != address) {
+        return;
+    }
+    auto &cached = entry->second;
+    if (++cached.failures >= cached.addresses.size()) {
+        entries.erase(entry);
+        return;
+    }
+    cached.current = (cached.current + 1) % cached.addresses.size();
+}
+
+void HttpDnsCache::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+}
+
+} // namespace duckdb
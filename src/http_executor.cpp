@@ -0,0 +1,150 @@
+#include "http_executor.hpp"
+
+#include <atomic>
+#include <exception>
+#include <system_error>
+
+namespace duckdb {
+
+HttpExecutor::~HttpExecutor() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        shutdown = true;
+    }
+    job_available.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+idx_t HttpExecutor::EnsureThreads(idx_t thread_count) {
+    std::lock_guard<std::mutex> guard(lock);
+    while (threads.size() < thread_count) {
+        try {
+            threads.emplace_back([this]() { WorkerLoop(); });
+        } catch (std::system_error &) {
+            // Out of threads, continue with the workers we have
+            break;
+        }
+    }
+    return threads.size();
+}
+
+void HttpExecutor::Submit(std::function<void()> job, const void *owner) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Job entry;
+        entry.run = std::move(job);
+        entry.owner = owner;
+        jobs.push_back(std::move(entry));
+    }
+    job_available.notify_one();
+}
+
+idx_t HttpExecutor::Withdraw(const void *owner) {
+    std::lock_guard<std::mutex> guard(lock);
+    idx_t withdrawn = 0;
+    for (auto it = jobs.begin(); it != jobs.end();) {
+        if (it->owner == owner) {
+            it = jobs.erase(it);
+            withdrawn++;
+        } else {
+            ++it;
+        }
+    }
+    return withdrawn;
+}
+
+void HttpExecutor::WorkerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            job_available.wait(guard, [&]() { return shutdown || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front().run);
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+namespace {
+
+//! Shared by the jobs of one Run() call, lives on the caller's stack until all of them have finished
+struct HttpBatch {
+    HttpBatch(idx_t count, const std::function<void(idx_t)> &task) : count(count), task(task) {
+    }
+
+    void Drain() {
+        // Rows are handed out one at a time, so a slow response only holds back its own worker
+        for (idx_t i = next_row++; i < count && !failed; i = next_row++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    }
+
+    void JobFinished() {
+        std::lock_guard<std::mutex> guard(lock);
+        finished_jobs++;
+        done.notify_one();
+    }
+
+    const idx_t count;
+    const std::function<void(idx_t)> &task;
+    std::atomic<idx_t> next_row {0};
+    std::atomic<bool> failed {false};
+
+    std::mutex lock;
+    std::condition_variable done;
+    idx_t finished_jobs = 0;
+    std::exception_ptr error;
+};
+
+} // namespace
+
+void HttpExecutor::Run(idx_t count, idx_t max_concurrency, idx_t io_threads,
+                       const std::function<void(idx_t)> &task) {
+    auto concurrency = MinValue<idx_t>(count, MaxValue<idx_t>(max_concurrency, 1));
+    if (concurrency <= 1 || io_threads == 0) {
+        for (idx_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    auto available = EnsureThreads(io_threads);
+    auto job_count = MinValue<idx_t>(concurrency - 1, available);
+
+    HttpBatch batch(count, task);
+    for (idx_t i = 0; i < job_count; i++) {
+        Submit(
+            [&batch]() {
+                batch.Drain();
+                batch.JobFinished();
+            },
+            &batch);
+    }
+    // The calling thread takes part too; if the I/O threads are busy with other queries it simply does more rows.
+    // Once all rows are handed out, jobs still queued behind other queries' work would find nothing left to do,
+    // so they are withdrawn instead of being waited for.
+    batch.Drain();
+    auto withdrawn = Withdraw(&batch);
+
+    std::unique_lock<std::mutex> guard(batch.lock);
+    batch.done.wait(guard, [&]() { return batch.finished_jobs + withdrawn == job_count; });
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,314 @@
+#include "duckdb.hpp"
+#include "duckdb/execution/execution_context.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+#include "http_request.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+namespace duckdb {
+
+//! Bytes of received bodies waiting to be emitted, the I/O jobs stop picking up URLs once this much is queued
+static constexpr idx_t HTTP_FETCH_BUFFER_SIZE = 64 * 1024 * 1024;
+
+struct HttpFetchBindData : public TableFunctionData {
+    vector<std::string> urls;
+};
+
+struct HttpFetchResult {
+    std::string url;
+    HttpResponse response;
+};
+
+//! Shared by the scan and the I/O jobs fetching for it. Jobs hold a reference of their own, so a scan that stops
+//! early (e.g. LIMIT) can go away while the requests already in flight finish.
+struct HttpFetchQueue {
+    explicit HttpFetchQueue(vector<HttpRequest> requests_p) : requests(std::move(requests_p)) {
+    }
+
+    //! Fetch the next URL and queue its response. Returns false once no URL is left, the scan was cancelled or
+    //! the scan is too far behind; the scan starts jobs again once it has caught up.
+    bool FetchNext(HttpClientState &client_state, const HttpClientSettings &settings) {
+        if (buffered >= HTTP_FETCH_BUFFER_SIZE) {
+            return false;
+        }
+        auto index = next_url++;
+        if (cancelled || index >= requests.size()) {
+            return false;
+        }
+
+        auto &request = requests[index];
+        HttpResponse response;
+        try {
+            response = PerformHttpRequest(client_state, settings, request);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!error) {
+                error = std::current_exception();
+            }
+            cancelled = true;
+            ready.notify_all();
+            return false;
+        }
+
+        // Unlike http_get neither a non-200 status nor a failed request is an error here, they are reported in the
+        // status and reason columns
+        HttpFetchResult result {request.url, std::move(response)};
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            buffered += result.response.body.size();
+            results.push_back(std::move(result));
+        }
+        ready.notify_one();
+        return true;
+    }
+
+    //! Whether URLs are left that no request was sent for yet
+    bool HasPending() const {
+        return !cancelled && next_url < requests.size();
+    }
+
+    const vector<HttpRequest> requests;
+    std::atomic<idx_t> next_url {0};
+    std::atomic<bool> cancelled {false};
+
+    std::mutex lock;
+    std::condition_variable ready;
+    //! Responses in completion order, waiting to be emitted
+    std::deque<HttpFetchResult> results;
+    //! Bytes of body in results
+    std::atomic<idx_t> buffered {0};
+    idx_t running_jobs = 0;
+    std::exception_ptr error;
+};
+
+struct HttpFetchGlobalState : public GlobalTableFunctionState {
+    ~HttpFetchGlobalState() override {
+        // Jobs still running finish their current request and then stop picking up URLs
+        queue->cancelled = true;
+    }
+
+    shared_ptr<HttpClientState> client_state;
+    HttpClientSettings settings;
+    shared_ptr<HttpFetchQueue> queue;
+    //! Number of I/O jobs fetching for this scan, 0 when the scan fetches by itself
+    idx_t job_count = 0;
+};
+
+static void AddFetchColumns(vector<LogicalType> &return_types, vector<string> &names) {
+    names = {"url", "status", "reason", "headers", "body", "elapsed_ms"};
+    return_types = {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR,
+                    HttpHeadersType(),    LogicalType::BLOB,    LogicalType::DOUBLE};
+}
+
+static unique_ptr<FunctionData> HttpFetchBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<HttpFetchBindData>();
+    auto &urls = input.inputs[0];
+    if (!urls.IsNull()) {
+        if (urls.type().id() == LogicalTypeId::LIST) {
+            for (auto &url : ListValue::GetChildren(urls)) {
+                if (!url.IsNull()) {
+                    result->urls.push_back(StringValue::Get(url));
+                }
+            }
+        } else {
+            result->urls.push_back(StringValue::Get(urls));
+        }
+    }
+
+    AddFetchColumns(return_types, names);
+    return std::move(result);
+}
+
+// Start I/O jobs until job_count are fetching, as long as URLs are left
+static void StartFetchJobs(HttpFetchGlobalState &state) {
+    auto &queue = state.queue;
+    idx_t new_jobs;
+    {
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if (!queue->HasPending() || queue->running_jobs >= state.job_count) {
+            return;
+        }
+        new_jobs = state.job_count - queue->running_jobs;
+        queue->running_jobs = state.job_count;
+    }
+    // The executor is joined before the rest of the client state is destroyed, so a raw pointer is safe here
+    auto client_state = state.client_state.get();
+    auto &settings = state.settings;
+    for (idx_t i = 0; i < new_jobs; i++) {
+        client_state->executor.Submit([queue, client_state, settings]() {
+            while (queue->FetchNext(*client_state, settings)) {
+            }
+            std::lock_guard<std::mutex> guard(queue->lock);
+            queue->running_jobs--;
+            queue->ready.notify_all();
+        });
+    }
+}
+
+static unique_ptr<GlobalTableFunctionState> HttpFetchInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<HttpFetchBindData>();
+    auto result = make_uniq<HttpFetchGlobalState>();
+    result->client_state = HttpClientState::Get(context);
+    result->settings = HttpClientSettings::Get(context);
+    HttpUrlResolver resolver(result->settings, &result->client_state->metrics);
+    vector<HttpRequest> requests(bind_data.urls.size());
+    for (idx_t i = 0; i < requests.size(); i++) {
+        requests[i].url = bind_data.urls[i];
+        resolver.Resolve(requests[i]);
+    }
+    result->queue = make_shared_ptr<HttpFetchQueue>(std::move(requests));
+
+    auto &settings = result->settings;
+    // The jobs may outlive the scan (and its context), so they are interrupted through the queue's flag
+    settings.interrupted = &result->queue->cancelled;
+    auto concurrency = MinValue<idx_t>(bind_data.urls.size(), settings.max_concurrency);
+    if (concurrency > 1 && settings.io_threads > 0) {
+        result->job_count = MinValue<idx_t>(concurrency, result->client_state->executor.EnsureThreads(settings.io_threads));
+    }
+    StartFetchJobs(*result);
+    return std::move(result);
+}
+
+// Write one row per result: a request that got no response has a NULL status and body, and its error as reason
+static void WriteFetchResults(const std::deque<HttpFetchResult> &results, DataChunk &output) {
+    auto urls = FlatVector::GetData<string_t>(output.data[0]);
+    auto statuses = FlatVector::GetData<int32_t>(output.data[1]);
+    auto reasons = FlatVector::GetData<string_t>(output.data[2]);
+    auto bodies = FlatVector::GetData<string_t>(output.data[4]);
+    auto elapsed = FlatVector::GetData<double>(output.data[5]);
+    idx_t row = 0;
+    for (auto &result : results) {
+        auto &response = result.response;
+        urls[row] = StringVector::AddString(output.data[0], result.url);
+        elapsed[row] = response.elapsed_ms;
+        if (!response.received) {
+            FlatVector::SetNull(output.data[1], row, true);
+            reasons[row] = StringVector::AddString(output.data[2], response.error);
+            output.data[3].SetValue(row, Value(HttpHeadersType()));
+            FlatVector::SetNull(output.data[4], row, true);
+        } else {
+            statuses[row] = response.status;
+            reasons[row] = StringVector::AddString(output.data[2], response.reason);
+            output.data[3].SetValue(row, HttpHeadersToValue(response.headers));
+            bodies[row] = StringVector::AddStringOrBlob(output.data[4], response.body);
+        }
+        row++;
+    }
+    output.SetCardinality(row);
+}
+
+// Take whatever has arrived, waiting only until at least one response is there
+static std::deque<HttpFetchResult> NextFetchResults(ClientContext &context, HttpFetchGlobalState &state) {
+    auto &queue = *state.queue;
+    if (state.job_count == 0) {
+        auto settings = state.settings;
+        settings.interrupted = &context.interrupted;
+        queue.FetchNext(*state.client_state, settings);
+    } else {
+        // Jobs that stopped because the scan fell behind are started again now that it has caught up
+        StartFetchJobs(state);
+    }
+
+    std::deque<HttpFetchResult> batch;
+    std::unique_lock<std::mutex> guard(queue.lock);
+    while (!queue.ready.wait_for(guard, std::chrono::milliseconds(100), [&]() {
+        return !queue.results.empty() || queue.error || queue.running_jobs == 0;
+    })) {
+        if (context.interrupted) {
+            // Aborts the requests in flight, the jobs then stop
+            queue.cancelled = true;
+            throw InterruptException();
+        }
+    }
+    if (context.interrupted) {
+        queue.cancelled = true;
+        throw InterruptException();
+    }
+    if (queue.error) {
+        std::rethrow_exception(queue.error);
+    }
+    while (!queue.results.empty() && batch.size() < STANDARD_VECTOR_SIZE) {
+        queue.buffered -= queue.results.front().response.body.size();
+        batch.push_back(std::move(queue.results.front()));
+        queue.results.pop_front();
+    }
+    return batch;
+}
+
+static void HttpFetchFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpFetchGlobalState>();
+    auto batch = NextFetchResults(context, state);
+    // Nothing arrived while URLs are left when every job had stopped for the scan to catch up, so it is not done
+    while (batch.empty() && state.queue->HasPending()) {
+        batch = NextFetchResults(context, state);
+    }
+    WriteFetchResults(batch, output);
+}
+
+static unique_ptr<FunctionData> HttpFetchTableBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    if (input.input_table_types.empty() || input.input_table_types[0].id() != LogicalTypeId::VARCHAR) {
+        throw BinderException("http_fetch expects a subquery whose first column holds the urls as VARCHAR");
+    }
+    AddFetchColumns(return_types, names);
+    return make_uniq<TableFunctionData>();
+}
+
+// http_fetch((SELECT url FROM ...)): every chunk of urls is fetched concurrently and returned in input order, so no
+// more than one chunk of responses is held at a time
+static OperatorResultType HttpFetchTableFunction(ExecutionContext &context, TableFunctionInput &data,
+                                                 DataChunk &input, DataChunk &output) {
+    auto &client = context.client;
+    auto client_state = HttpClientState::Get(client);
+    auto settings = HttpClientSettings::Get(client);
+
+    UnifiedVectorFormat url_format;
+    input.data[0].ToUnifiedFormat(input.size(), url_format);
+    auto url_data = UnifiedVectorFormat::GetData<string_t>(url_format);
+    HttpUrlResolver resolver(settings, &client_state->metrics);
+    vector<HttpRequest> requests;
+    for (idx_t row = 0; row < input.size(); row++) {
+        auto index = url_format.sel->get_index(row);
+        if (url_format.validity.RowIsValid(index)) {
+            HttpRequest request;
+            request.url = url_data[index].GetString();
+            resolver.Resolve(request);
+            requests.push_back(std::move(request));
+        }
+    }
+
+    std::deque<HttpFetchResult> results(requests.size());
+    client_state->executor.Run(requests.size(), settings.max_concurrency, settings.io_threads, [&](idx_t i) {
+        results[i].url = requests[i].url;
+        results[i].response = PerformHttpRequest(*client_state, settings, requests[i]);
+    });
+    if (client.interrupted) {
+        throw InterruptException();
+    }
+    WriteFetchResults(results, output);
+    return OperatorResultType::NEED_MORE_INPUT;
+}
+
+void HTTPFunctions::RegisterHTTPFetchFunction(DatabaseInstance &instance) {
+    TableFunctionSet http_fetch("http_fetch");
+    http_fetch.AddFunction(TableFunction({LogicalType::LIST(LogicalType::VARCHAR)}, HttpFetchFunction,
+                                         HttpFetchBind, HttpFetchInit));
+    http_fetch.AddFunction(TableFunction({LogicalType::VARCHAR}, HttpFetchFunction, HttpFetchBind, HttpFetchInit));
+    TableFunction http_fetch_table({LogicalType::TABLE}, nullptr, HttpFetchTableBind);
+    http_fetch_table.in_out_function = HttpFetchTableFunction;
+    http_fetch.AddFunction(http_fetch_table);
+    ExtensionUtil::RegisterFunction(instance, http_fetch);
+}
+
+} // namespace duckdb
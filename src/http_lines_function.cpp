@@ -0,0 +1,245 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+#include "http_request.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace duckdb {
+
+//! Bytes of received body buffered ahead of the scan, the transfer pauses once this much is waiting
+static constexpr idx_t HTTP_LINES_BUFFER_SIZE = 8 * 1024 * 1024;
+
+struct HttpLinesBindData : public TableFunctionData {
+    HttpRequest request;
+};
+
+//! Body pieces handed from the thread receiving the response to the scan
+struct HttpLinesStream {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::string> pieces;
+    //! Bytes in pieces
+    idx_t buffered = 0;
+    //! Set once the transfer is over, successfully or not
+    bool done = false;
+    //! Set by the scan when it stops early, the transfer is then aborted
+    bool cancelled = false;
+    //! Mirrors cancelled for the request path, which stops the socket of a transfer blocked in a read
+    std::atomic<bool> aborted {false};
+    std::string error;
+
+    //! Queue a piece of the body, waiting while the scan is behind; returns false once the scan is gone
+    bool Push(const char *data, idx_t length) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return cancelled || buffered < HTTP_LINES_BUFFER_SIZE; });
+        if (cancelled) {
+            return false;
+        }
+        pieces.emplace_back(data, length);
+        buffered += length;
+        changed.notify_all();
+        return true;
+    }
+
+    void Finish(std::string error_p) {
+        std::lock_guard<std::mutex> guard(lock);
+        done = true;
+        error = std::move(error_p);
+        changed.notify_all();
+    }
+};
+
+struct HttpLinesGlobalState : public GlobalTableFunctionState {
+    ~HttpLinesGlobalState() override {
+        {
+            std::lock_guard<std::mutex> guard(stream->lock);
+            stream->cancelled = true;
+        }
+        stream->aborted = true;
+        stream->changed.notify_all();
+        if (receiver.joinable()) {
+            receiver.join();
+        }
+    }
+
+    shared_ptr<HttpLinesStream> stream;
+    //! Receives the response; it lives as long as the scan, so it is not taken from the shared I/O threads
+    std::thread receiver;
+
+    //! Piece the scan is currently splitting and how far it got
+    std::string piece;
+    idx_t offset = 0;
+    //! Start of a line whose end has not arrived yet
+    std::string partial;
+    //! http_client_max_line_size, partial never grows beyond it
+    idx_t max_line_size;
+    bool finished = false;
+};
+
+static unique_ptr<FunctionData> HttpLinesBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<HttpLinesBindData>();
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("read_http_lines requires a non-NULL url");
+    }
+    result->request.url = StringValue::Get(input.inputs[0]);
+    for (auto &param : input.named_parameters) {
+        if (param.first == "headers" && !param.second.IsNull()) {
+            result->request.headers = HttpHeadersFromValue(param.second);
+        }
+    }
+
+    names = {"line"};
+    return_types = {LogicalType::VARCHAR};
+    return std::move(result);
+}
+
+static void ReceiveHttpLines(shared_ptr<HttpClientState> client_state, HttpClientSettings settings,
+                             HttpRequest request, shared_ptr<HttpLinesStream> stream) {
+    std::string error;
+    try {
+        auto response = StreamHttpRequest(
+            *client_state, settings, request,
+            [&](const duckdb_httplib_openssl::Response &res) {
+                if (res.status != 200) {
+                    error = "HTTP GET error: " + std::to_string(res.status) + " - " + res.reason;
+                    return false;
+                }
+                return true;
+            },
+            [&](const char *data, idx_t length) { return stream->Push(data, length); });
+        if (error.empty() && !response.received) {
+            error = response.error;
+        }
+    } catch (std::exception &ex) {
+        error = ex.what();
+    }
+    stream->Finish(std::move(error));
+}
+
+static unique_ptr<GlobalTableFunctionState> HttpLinesInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<HttpLinesBindData>();
+    auto result = make_uniq<HttpLinesGlobalState>();
+    result->stream = make_shared_ptr<HttpLinesStream>();
+    auto settings = HttpClientSettings::Get(context);
+    settings.interrupted = &result->stream->aborted;
+    result->max_line_size = settings.max_line_size;
+    auto client_state = HttpClientState::Get(context);
+    auto request = bind_data.request;
+    HttpUrlResolver(settings, &client_state->metrics).Resolve(request);
+    try {
+        result->receiver =
+            std::thread(ReceiveHttpLines, std::move(client_state), settings, std::move(request), result->stream);
+    } catch (std::system_error &ex) {
+        throw std::runtime_error(std::string("read_http_lines could not start its receiving thread: ") + ex.what());
+    }
+    return std::move(result);
+}
+
+// Take the next piece of the body, waiting for one only when nothing has been emitted yet in this chunk.
+// Returns false when there is none (yet).
+static bool NextPiece(ClientContext &context, HttpLinesGlobalState &state, bool wait) {
+    auto &stream = *state.stream;
+    std::unique_lock<std::mutex> guard(stream.lock);
+    if (wait) {
+        while (!stream.changed.wait_for(guard, std::chrono::milliseconds(100),
+                                        [&]() { return !stream.pieces.empty() || stream.done; })) {
+            if (context.interrupted) {
+                // The global state aborts the transfer when it is destroyed
+                throw InterruptException();
+            }
+        }
+    }
+    if (stream.pieces.empty()) {
+        if (stream.done && !stream.error.empty()) {
+            throw std::runtime_error(stream.error);
+        }
+        state.finished = stream.done;
+        return false;
+    }
+    state.piece = std::move(stream.pieces.front());
+    state.offset = 0;
+    stream.pieces.pop_front();
+    stream.buffered -= state.piece.size();
+    stream.changed.notify_all();
+    return true;
+}
+
+static void CheckLineSize(const HttpLinesGlobalState &state, idx_t length) {
+    if (length > state.max_line_size) {
+        throw std::runtime_error("read_http_lines: line exceeds " + std::to_string(state.max_line_size) +
+                                 " bytes (http_client_max_line_size)");
+    }
+}
+
+// Add to the line being assembled, checked before it grows so that a body without newlines is not buffered whole
+static void AppendPartialLine(HttpLinesGlobalState &state, const char *data, idx_t length) {
+    CheckLineSize(state, state.partial.size() + length);
+    state.partial.append(data, length);
+}
+
+static void HttpLinesFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpLinesGlobalState>();
+    auto &lines = output.data[0];
+    auto line_data = FlatVector::GetData<string_t>(lines);
+
+    idx_t row = 0;
+    auto emit = [&](const char *line, idx_t length) {
+        // Lines may end in CRLF
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        CheckLineSize(state, length);
+        line_data[row++] = StringVector::AddString(lines, line, length);
+    };
+
+    while (row < STANDARD_VECTOR_SIZE && !state.finished) {
+        if (state.offset >= state.piece.size() && !NextPiece(context, state, row == 0)) {
+            if (state.finished && !state.partial.empty()) {
+                // The last line has no newline
+                emit(state.partial.data(), state.partial.size());
+                state.partial.clear();
+            }
+            break;
+        }
+        auto start = state.piece.data() + state.offset;
+        auto remaining = state.piece.size() - state.offset;
+        auto newline = static_cast<const char *>(memchr(start, '\n', remaining));
+        if (!newline) {
+            AppendPartialLine(state, start, remaining);
+            state.offset = state.piece.size();
+            continue;
+        }
+        auto length = static_cast<idx_t>(newline - start);
+        if (state.partial.empty()) {
+            emit(start, length);
+        } else {
+            AppendPartialLine(state, start, length);
+            emit(state.partial.data(), state.partial.size());
+            state.partial.clear();
+        }
+        state.offset += length + 1;
+    }
+    output.SetCardinality(row);
+}
+
+void HTTPFunctions::RegisterHTTPLinesFunction(DatabaseInstance &instance) {
+    TableFunction read_http_lines("read_http_lines", {LogicalType::VARCHAR}, HttpLinesFunction, HttpLinesBind,
+                                  HttpLinesInit);
+    read_http_lines.named_parameters["headers"] = LogicalType::ANY;
+    ExtensionUtil::RegisterFunction(instance, read_http_lines);
+}
+
+} // namespace duckdb
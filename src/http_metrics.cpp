@@ -0,0 +1,101 @@
+#include "http_metrics.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+// Bucket i has the upper bound 2^(i - BUCKET_OFFSET) ms
+static constexpr int BUCKET_OFFSET = 4;
+
+static double BucketUpperBound(idx_t bucket) {
+    return std::ldexp(1.0, static_cast<int>(bucket) - BUCKET_OFFSET);
+}
+
+void HttpLatencyHistogram::Record(double milliseconds) {
+    idx_t bucket = 0;
+    if (milliseconds > 0) {
+        int exponent;
+        // milliseconds = mantissa * 2^exponent with mantissa in [0.5, 1), so it is below 2^exponent
+        std::frexp(milliseconds, &exponent);
+        bucket = static_cast<idx_t>(MaxValue<int>(exponent + BUCKET_OFFSET, 0));
+    }
+    bucket = MinValue<idx_t>(bucket, BUCKET_COUNT - 1);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+idx_t HttpLatencyHistogram::Count() const {
+    idx_t count = 0;
+    for (auto &bucket : buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+double HttpLatencyHistogram::Quantile(double q) const {
+    auto count = Count();
+    if (count == 0) {
+        return 0;
+    }
+    auto rank = static_cast<idx_t>(std::ceil(q * static_cast<double>(count)));
+    idx_t seen = 0;
+    for (idx_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(BUCKET_COUNT - 1);
+}
+
+void HttpLatencyHistogram::Reset() {
+    for (auto &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+HttpHostMetrics &HttpMetrics::ForHost(const std::string &host) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto &entry = hosts[host];
+    if (!entry) {
+        entry = make_uniq<HttpHostMetrics>();
+    }
+    return *entry;
+}
+
+static idx_t Read(std::atomic<idx_t> &counter, bool reset) {
+    return reset ? counter.exchange(0) : counter.load();
+}
+
+vector<HttpHostMetricsSnapshot> HttpMetrics::Snapshot(bool reset) {
+    vector<HttpHostMetricsSnapshot> result;
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &entry : hosts) {
+        auto &metrics = *entry.second;
+        HttpHostMetricsSnapshot snapshot;
+        snapshot.host = entry.first;
+        snapshot.requests = Read(metrics.requests, reset);
+        snapshot.failures = Read(metrics.failures, reset);
+        snapshot.retries = Read(metrics.retries, reset);
+        snapshot.cache_hits = Read(metrics.cache_hits, reset);
+        snapshot.connections_opened = Read(metrics.connections_opened, reset);
+        snapshot.connections_reused = Read(metrics.connections_reused, reset);
+        snapshot.bytes_sent = Read(metrics.bytes_sent, reset);
+        snapshot.bytes_received = Read(metrics.bytes_received, reset);
+        snapshot.resolve_ms = static_cast<double>(Read(metrics.resolve_us, reset)) / 1000;
+        snapshot.ttfb_p50_ms = metrics.time_to_first_byte.Quantile(0.5);
+        snapshot.ttfb_p99_ms = metrics.time_to_first_byte.Quantile(0.99);
+        snapshot.transfer_p50_ms = metrics.transfer.Quantile(0.5);
+        snapshot.transfer_p99_ms = metrics.transfer.Quantile(0.99);
+        snapshot.latency_p50_ms = metrics.latency.Quantile(0.5);
+        snapshot.latency_p99_ms = metrics.latency.Quantile(0.99);
+        if (reset) {
+            metrics.time_to_first_byte.Reset();
+            metrics.transfer.Reset();
+            metrics.latency.Reset();
+        }
+        result.push_back(std::move(snapshot));
+    }
+    return result;
+}
+
+} // namespace duckdb
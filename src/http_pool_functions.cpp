@@ -0,0 +1,125 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+#include "http_request.hpp"
+
+namespace duckdb {
+
+struct HttpHostsState : public GlobalTableFunctionState {
+    vector<HttpHostStats> hosts;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> HttpHostsBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+    names = {"host", "active", "idle", "concurrency_limit", "latency_ms", "successes", "overloads", "pinned"};
+    return_types = {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::UBIGINT,
+                    LogicalType::UBIGINT, LogicalType::DOUBLE,  LogicalType::UBIGINT,
+                    LogicalType::UBIGINT, LogicalType::UBIGINT};
+    return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> HttpHostsInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto result = make_uniq<HttpHostsState>();
+    result->hosts = HttpClientState::Get(context)->pool.GetHostStats();
+    return std::move(result);
+}
+
+static void HttpHostsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpHostsState>();
+    idx_t row = 0;
+    for (; state.offset < state.hosts.size() && row < STANDARD_VECTOR_SIZE; state.offset++, row++) {
+        auto &host = state.hosts[state.offset];
+        output.SetValue(0, row, Value(host.host));
+        output.SetValue(1, row, Value::UBIGINT(host.active));
+        output.SetValue(2, row, Value::UBIGINT(host.idle));
+        output.SetValue(3, row, Value::UBIGINT(host.limit));
+        output.SetValue(4, row, Value::DOUBLE(host.latency_ms));
+        output.SetValue(5, row, Value::UBIGINT(host.successes));
+        output.SetValue(6, row, Value::UBIGINT(host.overloads));
+        output.SetValue(7, row, Value::UBIGINT(host.pinned));
+    }
+    output.SetCardinality(row);
+}
+
+struct HttpPrewarmBindData : public TableFunctionData {
+    vector<std::string> urls;
+    idx_t connections = 1;
+};
+
+struct HttpPrewarmResult {
+    std::string host;
+    idx_t connections = 0;
+    std::string error;
+};
+
+struct HttpPrewarmState : public GlobalTableFunctionState {
+    vector<HttpPrewarmResult> results;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> HttpPrewarmBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<HttpPrewarmBindData>();
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("http_client_prewarm requires a non-NULL list of urls");
+    }
+    for (auto &url : ListValue::GetChildren(input.inputs[0])) {
+        if (!url.IsNull()) {
+            result->urls.push_back(StringValue::Get(url));
+        }
+    }
+    for (auto &param : input.named_parameters) {
+        if (param.first == "connections" && !param.second.IsNull()) {
+            result->connections = UBigIntValue::Get(param.second);
+        }
+    }
+
+    names = {"host", "connections", "error"};
+    return_types = {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::VARCHAR};
+    return std::move(result);
+}
+
+// Warm all hosts before the first row is returned, so the connections are open once the call is done
+static unique_ptr<GlobalTableFunctionState> HttpPrewarmInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<HttpPrewarmBindData>();
+    auto result = make_uniq<HttpPrewarmState>();
+    auto settings = HttpClientSettings::Get(context);
+    auto client_state = HttpClientState::Get(context);
+    auto endpoints = HttpEndpointsOf(settings, bind_data.urls);
+    result->results.resize(endpoints.size());
+    client_state->executor.Run(endpoints.size(), settings.max_concurrency, settings.io_threads, [&](idx_t i) {
+        auto &host = result->results[i];
+        host.host = endpoints[i].ToString();
+        host.connections = client_state->pool.Prewarm(endpoints[i], settings, bind_data.connections, host.error);
+    });
+    return std::move(result);
+}
+
+static void HttpPrewarmFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpPrewarmState>();
+    idx_t row = 0;
+    for (; state.offset < state.results.size() && row < STANDARD_VECTOR_SIZE; state.offset++, row++) {
+        auto &host = state.results[state.offset];
+        output.SetValue(0, row, Value(host.host));
+        output.SetValue(1, row, Value::UBIGINT(host.connections));
+        output.SetValue(2, row, host.error.empty() ? Value(LogicalType::VARCHAR) : Value(host.error));
+    }
+    output.SetCardinality(row);
+}
+
+void HTTPFunctions::RegisterHTTPPoolFunctions(DatabaseInstance &instance) {
+    TableFunction http_client_hosts("http_client_hosts", {}, HttpHostsFunction, HttpHostsBind, HttpHostsInit);
+    ExtensionUtil::RegisterFunction(instance, http_client_hosts);
+
+    TableFunction http_client_prewarm("http_client_prewarm", {LogicalType::LIST(LogicalType::VARCHAR)},
+                                      HttpPrewarmFunction, HttpPrewarmBind, HttpPrewarmInit);
+    http_client_prewarm.named_parameters["connections"] = LogicalType::UBIGINT;
+    ExtensionUtil::RegisterFunction(instance, http_client_prewarm);
+}
+
+} // namespace duckdb
@@ -0,0 +1,129 @@
+#include "http_query_state.hpp"
+#include "duckdb/main/client_context.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace duckdb {
+
+shared_ptr<HttpResponse> HttpRequestDeduplicator::Perform(const std::string &key, const HttpRequest &request,
+                                                          idx_t memo_budget, const std::atomic<bool> *interrupted,
+                                                          const std::function<HttpResponse()> &perform) {
+    shared_ptr<Flight> flight;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &entry = flights[key];
+        if (!entry) {
+            entry = make_shared_ptr<Flight>();
+            entry->body.assign(request.BodyData(), request.BodySize());
+            leader = true;
+        }
+        flight = entry;
+    }
+    if (!leader && !request.SameBody(flight->body.data(), flight->body.size())) {
+        // Same hash, other body: nothing to share
+        return make_shared_ptr<HttpResponse>(perform());
+    }
+
+    if (!leader) {
+        std::unique_lock<std::mutex> guard(flight->lock);
+        while (!flight->completed.wait_for(guard, std::chrono::milliseconds(100), [&]() { return flight->done; })) {
+            if (interrupted && *interrupted) {
+                // The leader notices the interrupt on its own
+                throw InterruptException();
+            }
+        }
+        if (flight->error) {
+            std::rethrow_exception(flight->error);
+        }
+        return flight->response;
+    }
+
+    shared_ptr<HttpResponse> response;
+    std::exception_ptr error;
+    try {
+        response = make_shared_ptr<HttpResponse>(perform());
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        // Keep successful (2xx) responses for later repeats while they fit the budget. Failures, transient 429/5xx
+        // statuses included, are sent afresh by later repeats; only requests in flight right now share them.
+        std::lock_guard<std::mutex> guard(lock);
+        auto size = response ? key.size() + flight->body.size() + response->body.size() : 0;
+        auto success = response && response->received && response->status >= 200 && response->status < 300;
+        if (success && memo_size + size <= memo_budget) {
+            memo_size += size;
+        } else {
+            flights.erase(key);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(flight->lock);
+        flight->done = true;
+        flight->response = response;
+        flight->error = error;
+    }
+    flight->completed.notify_all();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return response;
+}
+
+void HttpRequestDeduplicator::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    flights.clear();
+    memo_size = 0;
+}
+
+bool HttpRequestScheduler::Acquire(idx_t limit, const std::atomic<bool> *interrupted) {
+    std::unique_lock<std::mutex> guard(lock);
+    auto ticket = next_ticket++;
+    waiting.push_back(ticket);
+    while (!released.wait_for(guard, std::chrono::milliseconds(100),
+                              [&]() { return waiting.front() == ticket && in_flight < limit; })) {
+        if (interrupted && *interrupted) {
+            waiting.erase(std::find(waiting.begin(), waiting.end(), ticket));
+            // The next in line may be waiting for this one to go
+            released.notify_all();
+            return false;
+        }
+    }
+    waiting.pop_front();
+    in_flight++;
+    // The next in line may be able to go too
+    released.notify_all();
+    return true;
+}
+
+void HttpRequestScheduler::Release() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        in_flight--;
+    }
+    released.notify_all();
+}
+
+shared_ptr<HttpQueryState> HttpQueryState::Get(ClientContext &context) {
+    return context.registered_state->GetOrCreate<HttpQueryState>(STATE_KEY);
+}
+
+void HttpQueryState::QueryEnd(ClientContext &context) {
+    deduplicator.Clear();
+    std::lock_guard<std::mutex> guard(settings_lock);
+    settings.reset();
+}
+
+HttpClientSettings HttpQueryState::Settings(ClientContext &context) {
+    std::lock_guard<std::mutex> guard(settings_lock);
+    if (!settings) {
+        settings = make_uniq<HttpClientSettings>(HttpClientSettings::Get(context));
+    }
+    return *settings;
+}
+
+} // namespace duckdb
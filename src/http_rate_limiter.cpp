@@ -0,0 +1,55 @@
+#include "http_rate_limiter.hpp"
+
+#include <thread>
+
+namespace duckdb {
+
+bool InterruptibleSleepUntil(std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *interrupted) {
+    static constexpr std::chrono::milliseconds SLICE(50);
+    while (true) {
+        if (interrupted && interrupted->load()) {
+            return false;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        std::this_thread::sleep_for(MinValue<std::chrono::steady_clock::duration>(deadline - now, SLICE));
+    }
+}
+
+bool HttpRateLimiter::Wait(const std::string &host, double rate, const std::atomic<bool> *interrupted) {
+    if (rate <= 0) {
+        return true;
+    }
+    auto burst = MaxValue<double>(rate, 1);
+    Clock::time_point ready;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &bucket = buckets[host];
+        auto now = Clock::now();
+        if (!bucket.initialized) {
+            bucket.tokens = burst;
+            bucket.updated = now;
+            bucket.initialized = true;
+        }
+        auto refill = std::chrono::duration<double>(now - bucket.updated).count() * rate;
+        bucket.tokens = MinValue<double>(bucket.tokens + refill, burst) - 1;
+        bucket.updated = now;
+        // Every request takes its token right away, a negative balance is how long it has to wait for it
+        ready = now;
+        if (bucket.tokens < 0) {
+            ready += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(-bucket.tokens / rate));
+        }
+    }
+    if (InterruptibleSleepUntil(ready, interrupted)) {
+        return true;
+    }
+    // Nobody will send the request, so later requests need not wait for its token either
+    std::lock_guard<std::mutex> guard(lock);
+    auto &bucket = buckets[host];
+    bucket.tokens = MinValue<double>(bucket.tokens + 1, burst);
+    return false;
+}
+
+} // namespace duckdb
@@ -0,0 +1,744 @@
+#include "http_request.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+namespace duckdb {
+
+std::pair<HttpConnection, std::string> SetupHttpClient(HttpClientState &client_state,
+                                                       const HttpClientSettings &settings, const HttpRequest &request) {
+    if (request.endpoint) {
+        if (settings.rate_limit > 0) {
+            if (!client_state.rate_limiter.Wait(request.endpoint->ToString(), settings.rate_limit,
+                                                settings.interrupted)) {
+                throw InterruptException();
+            }
+        }
+        auto connection = client_state.pool.Acquire(*request.endpoint, settings);
+        return std::make_pair(std::move(connection), request.target);
+    }
+    auto parsed = HttpUrl::Parse(request.url);
+    if (settings.rate_limit > 0) {
+        if (!client_state.rate_limiter.Wait(parsed.endpoint.ToString(), settings.rate_limit, settings.interrupted)) {
+            throw InterruptException();
+        }
+    }
+    auto connection = client_state.pool.Acquire(parsed.endpoint, settings);
+    return std::make_pair(std::move(connection), std::move(parsed.path));
+}
+
+HttpUrlResolver::HttpUrlResolver(const HttpClientSettings &settings, HttpMetrics *metrics)
+    : base_url(settings.base_url), metrics(metrics) {
+    while (!base_url.empty() && base_url.back() == '/') {
+        base_url.pop_back();
+    }
+}
+
+void HttpUrlResolver::Resolve(HttpRequest &request) {
+    auto &url = request.url;
+    auto scheme_end = url.find("://");
+    if (scheme_end == std::string::npos && !base_url.empty()) {
+        // Relative to the base URL; "/path", "path" and "?query" are all appended to it
+        url.insert(0, !url.empty() && (url[0] == '/' || url[0] == '?') ? base_url : base_url + "/");
+        scheme_end = url.find("://");
+    }
+
+    auto authority_start = scheme_end == std::string::npos ? 0 : scheme_end + 3;
+    auto authority_end = url.find_first_of("/?#", authority_start);
+    if (authority_end == std::string::npos) {
+        authority_end = url.size();
+    }
+    if (last_endpoint && url.compare(0, authority_end, last_authority) == 0 &&
+        last_authority.size() == authority_end) {
+        request.target = HttpUrl::ParseTarget(url, authority_end);
+    } else {
+        auto parsed = HttpUrl::Parse(url);
+        last_authority = url.substr(0, authority_end);
+        if (metrics) {
+            parsed.endpoint.metrics = &metrics->ForHost(parsed.endpoint.ToString());
+        }
+        last_endpoint = make_shared_ptr<HttpEndpoint>(std::move(parsed.endpoint));
+        request.target = std::move(parsed.path);
+    }
+    request.endpoint = last_endpoint;
+}
+
+vector<HttpEndpoint> HttpEndpointsOf(const HttpClientSettings &settings, const vector<std::string> &urls) {
+    vector<HttpEndpoint> endpoints;
+    std::unordered_set<std::string> seen;
+    HttpUrlResolver resolver(settings);
+    for (auto &url : urls) {
+        HttpRequest request;
+        request.url = url;
+        resolver.Resolve(request);
+        if (seen.insert(request.endpoint->ToString()).second) {
+            endpoints.push_back(*request.endpoint);
+        }
+    }
+    return endpoints;
+}
+
+void PrewarmHttpHosts(HttpClientState &client_state, HttpClientSettings settings, const vector<std::string> &urls,
+                      idx_t connections) {
+    auto endpoints = HttpEndpointsOf(settings, urls);
+    if (endpoints.empty() || client_state.executor.EnsureThreads(settings.io_threads) == 0) {
+        return;
+    }
+    // Nobody waits for the jobs, so they must not hold on to the caller's interrupt flag. The state is not
+    // captured by reference count: the I/O threads finish their queue before the rest of the state goes away.
+    settings.interrupted = nullptr;
+    auto pool = &client_state.pool;
+    for (auto &endpoint : endpoints) {
+        client_state.executor.Submit([pool, settings, endpoint, connections]() {
+            // A host that cannot be reached yet is tried again by the heartbeat
+            std::string error;
+            pool->Prewarm(endpoint, settings, connections, error);
+        });
+    }
+}
+
+std::string HttpErrorMessage(const duckdb_httplib_openssl::Result &res, const std::string &request_type) {
+    return HttpErrorMessage(res.error(), request_type);
+}
+
+std::string HttpErrorMessage(duckdb_httplib_openssl::Error error, const std::string &request_type) {
+    std::string err_message = "HTTP " + request_type + " request failed. ";
+
+    switch (error) {
+        case duckdb_httplib_openssl::Error::Connection:
+            err_message += "Connection error.";
+            break;
+        case duckdb_httplib_openssl::Error::BindIPAddress:
+            err_message += "Failed to bind IP address.";
+            break;
+        case duckdb_httplib_openssl::Error::Read:
+            err_message += "Error reading response.";
+            break;
+        case duckdb_httplib_openssl::Error::Write:
+            err_message += "Error writing request.";
+            break;
+        case duckdb_httplib_openssl::Error::ExceedRedirectCount:
+            err_message += "Too many redirects.";
+            break;
+        case duckdb_httplib_openssl::Error::Canceled:
+            err_message += "Request was canceled.";
+            break;
+        case duckdb_httplib_openssl::Error::SSLConnection:
+            err_message += "SSL connection failed.";
+            break;
+        case duckdb_httplib_openssl::Error::SSLLoadingCerts:
+            err_message += "Failed to load SSL certificates.";
+            break;
+        case duckdb_httplib_openssl::Error::SSLServerVerification:
+            err_message += "SSL server verification failed.";
+            break;
+        case duckdb_httplib_openssl::Error::UnsupportedMultipartBoundaryChars:
+            err_message += "Unsupported characters in multipart boundary.";
+            break;
+        case duckdb_httplib_openssl::Error::Compression:
+            err_message += "Error during compression.";
+            break;
+        default:
+            err_message += "Unknown error.";
+            break;
+    }
+    return err_message;
+}
+
+void HandleHttpError(const duckdb_httplib_openssl::Result &res, const std::string &request_type) {
+    throw std::runtime_error(HttpErrorMessage(res, request_type));
+}
+
+duckdb_httplib_openssl::Headers ParseHttpHeaders(const char *data, idx_t length) {
+    duckdb_httplib_openssl::Headers header_map;
+    // Lines may end in CRLF, the CR is trimmed with the other whitespace
+    auto is_blank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    auto end = data + length;
+    for (auto line = data; line < end;) {
+        auto line_end = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (!line_end) {
+            line_end = end;
+        }
+        auto colon = static_cast<const char *>(memchr(line, ':', line_end - line));
+        if (colon) {
+            // Trim leading and trailing whitespace
+            auto key_start = line;
+            auto key_end = colon;
+            auto value_start = colon + 1;
+            auto value_end = line_end;
+            while (key_start < key_end && is_blank(*key_start)) {
+                key_start++;
+            }
+            while (key_end > key_start && is_blank(key_end[-1])) {
+                key_end--;
+            }
+            while (value_start < value_end && is_blank(*value_start)) {
+                value_start++;
+            }
+            while (value_end > value_start && is_blank(value_end[-1])) {
+                value_end--;
+            }
+            header_map.emplace(std::string(key_start, key_end), std::string(value_start, value_end));
+        }
+        line = line_end + 1;
+    }
+    return header_map;
+}
+
+duckdb_httplib_openssl::Headers ParseHttpHeaders(const std::string &headers) {
+    return ParseHttpHeaders(headers.data(), headers.size());
+}
+
+duckdb_httplib_openssl::Headers HttpHeadersFromValue(const Value &headers) {
+    if (headers.IsNull()) {
+        return duckdb_httplib_openssl::Headers();
+    }
+    if (headers.type().id() != LogicalTypeId::MAP) {
+        return ParseHttpHeaders(headers.ToString());
+    }
+    duckdb_httplib_openssl::Headers header_map;
+    for (auto &entry : MapValue::GetChildren(headers)) {
+        auto &key_value = StructValue::GetChildren(entry);
+        if (!key_value[0].IsNull() && !key_value[1].IsNull()) {
+            header_map.emplace(key_value[0].ToString(), key_value[1].ToString());
+        }
+    }
+    return header_map;
+}
+
+static bool IsInterrupted(const HttpClientSettings &settings) {
+    return settings.interrupted && settings.interrupted->load();
+}
+
+// Compress a request body with the gzip compressor httplib brings along for its content encoding support
+static std::string GzipCompress(const char *data, idx_t size) {
+    std::string compressed;
+    duckdb_httplib_openssl::detail::gzip_compressor compressor;
+    auto done = compressor.compress(data, size, true, [&](const char *chunk, size_t length) {
+        compressed.append(chunk, length);
+        return true;
+    });
+    if (!done) {
+        throw std::runtime_error("Failed to gzip compress the request body");
+    }
+    return compressed;
+}
+
+// Metrics of the host a request goes to, looked up (under the metrics lock) only when the resolver did not
+static HttpHostMetrics &GetHostMetrics(HttpClientState &client_state, const HttpRequest &request) {
+    if (request.endpoint && request.endpoint->metrics) {
+        return *request.endpoint->metrics;
+    }
+    auto host = request.endpoint ? request.endpoint->ToString() : HttpUrl::Parse(request.url).endpoint.ToString();
+    return client_state.metrics.ForHost(host);
+}
+
+HttpResponse StreamHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                               const HttpRequest &request, const HttpResponseHandler &response_handler,
+                               const HttpContentReceiver &content_receiver) {
+    HttpResponse response;
+    auto start = std::chrono::steady_clock::now();
+    if (IsInterrupted(settings)) {
+        response.transport_error = duckdb_httplib_openssl::Error::Canceled;
+        response.error = HttpErrorMessage(response.transport_error, request.method);
+        return response;
+    }
+
+    // Use helper to setup client and parse URL
+    auto client_and_path = SetupHttpClient(client_state, settings, request);
+    auto &client = client_and_path.first;
+
+    duckdb_httplib_openssl::Request req;
+    req.method = request.method;
+    req.path = std::move(client_and_path.second);
+    req.headers = request.headers;
+    if (!req.has_header("Accept-Encoding")) {
+        // Compressed bodies are inflated by httplib on their way to content_receiver
+        req.set_header("Accept-Encoding", settings.compression ? "gzip, deflate" : "identity");
+    }
+    if (request.body_provider || request.BodySize() > 0 || HttpMethodTakesBody(request.method)) {
+        if (request.body_provider) {
+            // The length is not known up front, so the body goes out as chunks as the provider produces it
+            auto &provider = request.body_provider;
+            req.content_provider_ = [&](size_t offset, size_t, duckdb_httplib_openssl::DataSink &sink) {
+                return !IsInterrupted(settings) && provider(offset, sink);
+            };
+            req.is_chunked_content_provider_ = true;
+            req.set_header("Transfer-Encoding", "chunked");
+        } else if (settings.compress_requests && request.BodySize() > 0 && !req.has_header("Content-Encoding")) {
+            req.body = GzipCompress(request.BodyData(), request.BodySize());
+            req.set_header("Content-Encoding", "gzip");
+        } else if (request.BodySize() > 0) {
+            // Written to the socket straight from the request instead of being copied into req.body first
+            auto data = request.BodyData();
+            req.content_length_ = request.BodySize();
+            req.content_provider_ = [data](size_t offset, size_t length, duckdb_httplib_openssl::DataSink &sink) {
+                return sink.write(data + offset, length);
+            };
+        }
+        if (!req.has_header("Content-Type")) {
+            req.set_header("Content-Type", request.content_type);
+        }
+    }
+    auto &metrics = GetHostMetrics(client_state, request);
+    metrics.requests.fetch_add(1, std::memory_order_relaxed);
+    metrics.bytes_sent.fetch_add(req.body.empty() ? req.content_length_ : req.body.size(), std::memory_order_relaxed);
+    if (client.Reused()) {
+        metrics.connections_reused.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        metrics.connections_opened.fetch_add(1, std::memory_order_relaxed);
+        metrics.resolve_us.fetch_add(static_cast<idx_t>(client.ResolveMilliseconds() * 1000),
+                                     std::memory_order_relaxed);
+    }
+
+    auto send_start = std::chrono::steady_clock::now();
+    auto first_byte = send_start;
+    bool headers_received = false;
+    // Redirect responses are not passed on, only the final one
+    req.response_handler = [&](const duckdb_httplib_openssl::Response &res) {
+        first_byte = std::chrono::steady_clock::now();
+        headers_received = true;
+        return !response_handler || response_handler(res);
+    };
+    req.content_receiver = [&](const char *data, size_t data_length, uint64_t, uint64_t) {
+        metrics.bytes_received.fetch_add(data_length, std::memory_order_relaxed);
+        return !IsInterrupted(settings) && content_receiver(data, data_length);
+    };
+
+    duckdb_httplib_openssl::Response res;
+    auto error = duckdb_httplib_openssl::Error::Success;
+    bool sent;
+    {
+        // Blocked in connect or read, the request is aborted by closing its socket from the watchdog thread
+        HttpWatchedRequest watched(client_state.watchdog, *client, settings.interrupted);
+        sent = client->send(req, res, error);
+    }
+    if (!sent && IsInterrupted(settings)) {
+        error = duckdb_httplib_openssl::Error::Canceled;
+    }
+    auto end = std::chrono::steady_clock::now();
+    response.elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    metrics.latency.Record(std::chrono::duration<double, std::milli>(end - send_start).count());
+    if (headers_received) {
+        metrics.time_to_first_byte.Record(std::chrono::duration<double, std::milli>(first_byte - send_start).count());
+        metrics.transfer.Record(std::chrono::duration<double, std::milli>(end - first_byte).count());
+    }
+    if (!sent) {
+        metrics.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Timeouts, refused connections, 429 and 5xx tell the host is struggling; an aborted transfer tells nothing
+    if (sent || error != duckdb_httplib_openssl::Error::Canceled) {
+        auto overloaded = sent ? res.status == 429 || res.status >= 500
+                               : error == duckdb_httplib_openssl::Error::Connection ||
+                                     error == duckdb_httplib_openssl::Error::Read ||
+                                     error == duckdb_httplib_openssl::Error::Write;
+        client.ReportOutcome(overloaded, response.elapsed_ms);
+    }
+    if (!sent) {
+        // The connection is in an unknown state so don't pool it
+        client.Invalidate(error);
+        response.error = HttpErrorMessage(error, request.method);
+        response.transport_error = error;
+        return response;
+    }
+
+    response.received = true;
+    response.status = res.status;
+    response.reason = std::move(res.reason);
+    response.headers = std::move(res.headers);
+    return response;
+}
+
+// Capacity reserved up front from Content-Length, larger bodies grow as they arrive so that a bogus header
+// cannot make us allocate more memory than the transfer actually needs
+static constexpr idx_t MAX_BODY_RESERVATION = 256 * 1024 * 1024;
+
+// Upper bound for a single wait between attempts, whatever Retry-After asks for
+static constexpr double MAX_RETRY_DELAY = 60;
+
+// Whether a failed attempt is worth repeating. Idempotent requests (GET, HEAD, PUT, DELETE, ...) are retried on
+// transport errors and the statuses that signal a transient condition; POST and PATCH only when they cannot have
+// been processed (no connection, 429, 503).
+static bool IsRetryable(const HttpRequest &request, const HttpResponse &response) {
+    bool idempotent = request.method != "POST" && request.method != "PATCH";
+    if (!response.received) {
+        switch (response.transport_error) {
+        case duckdb_httplib_openssl::Error::Connection:
+            return true;
+        case duckdb_httplib_openssl::Error::Read:
+        case duckdb_httplib_openssl::Error::Write:
+        case duckdb_httplib_openssl::Error::SSLConnection:
+            return idempotent;
+        default:
+            return false;
+        }
+    }
+    switch (response.status) {
+    case 429:
+    case 503:
+        return true;
+    case 408:
+    case 500:
+    case 502:
+    case 504:
+        return idempotent;
+    default:
+        return false;
+    }
+}
+
+// Seconds to wait before the next attempt: what Retry-After asks for (in seconds), otherwise exponential
+// backoff with jitter so that the rows of a chunk failing together don't all come back at once
+static double RetryDelay(const HttpClientSettings &settings, const HttpResponse &response, idx_t attempt) {
+    auto retry_after = response.headers.find("Retry-After");
+    if (retry_after != response.headers.end() && !retry_after->second.empty() &&
+        retry_after->second.find_first_not_of("0123456789") == std::string::npos && retry_after->second.size() < 6) {
+        return MinValue<double>(std::stod(retry_after->second), MAX_RETRY_DELAY);
+    }
+    static thread_local std::mt19937 random_engine(std::random_device {}());
+    std::uniform_real_distribution<double> jitter(0.5, 1.0);
+    auto backoff = MinValue<double>(settings.retry_backoff * std::pow(2.0, static_cast<double>(attempt)),
+                                    MAX_RETRY_DELAY);
+    return backoff * jitter(random_engine);
+}
+
+//! One attempt at sending a request with the given (possibly tightened) settings
+using HttpAttempt = std::function<HttpResponse(const HttpClientSettings &attempt_settings)>;
+
+// Repeat an attempt at a request while it fails transiently, up to http_client_max_retries times and within
+// http_client_timeout
+static HttpResponse SendWithRetries(HttpClientState &client_state, const HttpClientSettings &settings,
+                                    const HttpRequest &request, const HttpAttempt &send_attempt) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    HttpResponse response;
+    idx_t attempt = 0;
+    for (;; attempt++) {
+        auto attempt_settings = &settings;
+        HttpClientSettings limited;
+        if (settings.timeout > 0) {
+            // Don't let a single attempt outlast the overall timeout
+            auto remaining = MaxValue<double>(settings.timeout - elapsed(), 0.001);
+            limited = settings;
+            limited.connect_timeout = MinValue<double>(limited.connect_timeout, remaining);
+            limited.read_timeout = MinValue<double>(limited.read_timeout, remaining);
+            limited.write_timeout = MinValue<double>(limited.write_timeout, remaining);
+            attempt_settings = &limited;
+        }
+        response = send_attempt(*attempt_settings);
+
+        if (attempt >= settings.max_retries || !IsRetryable(request, response) || IsInterrupted(settings)) {
+            break;
+        }
+        auto delay = RetryDelay(settings, response, attempt);
+        if (settings.timeout > 0 && elapsed() + delay >= settings.timeout) {
+            break;
+        }
+        // An interrupt ends the backoff right away, like the wait for a rate limit token
+        auto resume = std::chrono::steady_clock::now() +
+                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(delay));
+        if (!InterruptibleSleepUntil(resume, settings.interrupted)) {
+            break;
+        }
+    }
+    if (attempt > 0) {
+        GetHostMetrics(client_state, request).retries.fetch_add(attempt, std::memory_order_relaxed);
+    }
+    response.elapsed_ms = elapsed() * 1000;
+    return response;
+}
+
+// Send the request over the network, bypassing the response cache, and retry transient failures
+static HttpResponse SendWholeHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                                         const HttpRequest &request) {
+    return SendWithRetries(client_state, settings, request, [&](const HttpClientSettings &attempt_settings) {
+        // Receive the body straight into one buffer instead of httplib's Response::body, so it is neither
+        // copied out of there nor reallocated while it grows when the server announces its length
+        std::string body;
+        auto response = StreamHttpRequest(
+            client_state, attempt_settings, request,
+            [&](const duckdb_httplib_openssl::Response &res) {
+                auto length = MinValue<uint64_t>(res.get_header_value_u64("Content-Length"), MAX_BODY_RESERVATION);
+                body = client_state.buffers.Take(length);
+                return true;
+            },
+            [&](const char *data, idx_t length) {
+                body.append(data, length);
+                return true;
+            });
+        if (response.received) {
+            response.body = std::move(body);
+        }
+        return response;
+    });
+}
+
+// Parse "bytes <first>-<last>/<total>" of a 206 response, returns false when it is missing or the total is unknown
+static bool ParseContentRange(const duckdb_httplib_openssl::Headers &headers, idx_t &first, idx_t &total) {
+    auto entry = headers.find("Content-Range");
+    if (entry == headers.end()) {
+        return false;
+    }
+    unsigned long long range_first, range_last, range_total;
+    if (sscanf(entry->second.c_str(), "bytes %llu-%llu/%llu", &range_first, &range_last, &range_total) != 3) {
+        return false;
+    }
+    first = range_first;
+    total = range_total;
+    return true;
+}
+
+// Download a GET response as concurrent Range requests of http_client_segment_size bytes. The first segment tells
+// the total size; a server that ignores Range simply answers it with the whole body.
+static HttpResponse SendSegmentedHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                                             const HttpRequest &request) {
+    auto start = std::chrono::steady_clock::now();
+    auto segment_size = settings.segment_size;
+    auto first_request = request;
+    first_request.headers.emplace("Range", "bytes=0-" + std::to_string(segment_size - 1));
+    if (first_request.headers.find("Accept-Encoding") == first_request.headers.end()) {
+        // Ranges of a compressed representation cannot be inflated one by one
+        first_request.headers.emplace("Accept-Encoding", "identity");
+    }
+    auto response = SendWholeHttpRequest(client_state, settings, first_request);
+    idx_t first = 0;
+    idx_t total = 0;
+    if (!response.received || response.status != 206 || !ParseContentRange(response.headers, first, total) ||
+        first != 0 || response.body.size() >= total) {
+        if (response.received && response.status == 206 && first == 0 && response.body.size() == total) {
+            // The whole object fit into the first segment
+            response.status = 200;
+            response.reason = "OK";
+            response.headers.erase("Content-Range");
+        }
+        return response;
+    }
+    if (total > settings.memory_limit) {
+        // The body is allocated from the server's Content-Range up front, a size beyond what DuckDB may use is not
+        // trusted: a single stream only grows the body as data actually arrives
+        client_state.buffers.Give(std::move(response.body), settings.buffer_pool_size);
+        return SendWholeHttpRequest(client_state, settings, request);
+    }
+
+    // The remaining segments go straight into their place in the body. If-Range makes a server whose object
+    // changed in between answer with a 200 instead, which fails the download rather than mixing two versions.
+    auto offset = response.body.size();
+    std::string body(total, '\0');
+    memcpy(&body[0], response.body.data(), offset);
+    client_state.buffers.Give(std::move(response.body), settings.buffer_pool_size);
+    auto segment_request = first_request;
+    auto etag = response.headers.find("ETag");
+    auto last_modified = response.headers.find("Last-Modified");
+    if (etag != response.headers.end() && !StringUtil::StartsWith(etag->second, "W/")) {
+        segment_request.headers.emplace("If-Range", etag->second);
+    } else if (last_modified != response.headers.end()) {
+        segment_request.headers.emplace("If-Range", last_modified->second);
+    }
+    auto segments = (total - offset + segment_size - 1) / segment_size;
+
+    std::mutex failure_lock;
+    HttpResponse failure;
+    std::atomic<bool> failed {false};
+    client_state.executor.Run(segments, settings.download_segments, settings.io_threads, [&](idx_t i) {
+        if (failed) {
+            return;
+        }
+        auto segment_start = offset + i * segment_size;
+        auto segment_length = MinValue<idx_t>(segment_size, total - segment_start);
+        auto range_request = segment_request;
+        range_request.headers.erase("Range");
+        range_request.headers.emplace("Range", "bytes=" + std::to_string(segment_start) + "-" +
+                                                   std::to_string(segment_start + segment_length - 1));
+        idx_t received = 0;
+        auto segment = SendWithRetries(client_state, settings, range_request, [&](const HttpClientSettings &s) {
+            received = 0;
+            bool expected = false;
+            return StreamHttpRequest(
+                client_state, s, range_request,
+                [&](const duckdb_httplib_openssl::Response &res) {
+                    idx_t range_first = 0;
+                    idx_t range_total = 0;
+                    expected = res.status == 206 && ParseContentRange(res.headers, range_first, range_total) &&
+                               range_first == segment_start && range_total == total;
+                    return true;
+                },
+                [&](const char *data, idx_t length) {
+                    if (!expected) {
+                        // Not our range (an error, or the object changed), only its status is looked at
+                        return true;
+                    }
+                    if (received + length > segment_length) {
+                        return false;
+                    }
+                    memcpy(&body[segment_start + received], data, length);
+                    received += length;
+                    return true;
+                });
+        });
+        if (segment.received && segment.status == 206 && received == segment_length) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(failure_lock);
+        if (!failed) {
+            failure = std::move(segment);
+            if (failure.received && failure.status < 300) {
+                failure.received = false;
+                failure.error = "HTTP GET error: the response changed or was cut short during a segmented download";
+            }
+            failed = true;
+        }
+    });
+    if (failed) {
+        failure.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return failure;
+    }
+
+    response.body = std::move(body);
+    response.status = 200;
+    response.reason = "OK";
+    response.headers.erase("Content-Range");
+    response.headers.erase("Content-Length");
+    response.headers.emplace("Content-Length", std::to_string(total));
+    response.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return response;
+}
+
+// Send the request over the network, bypassing the response cache
+static HttpResponse SendHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                                    const HttpRequest &request) {
+    if (settings.download_segments > 1 && request.method == "GET" &&
+        request.headers.find("Range") == request.headers.end()) {
+        return SendSegmentedHttpRequest(client_state, settings, request);
+    }
+    return SendWholeHttpRequest(client_state, settings, request);
+}
+
+// Answer from the persistent cache if allowed, otherwise send the request and keep the response there
+static HttpResponse FetchThroughDiskCache(HttpClientState &client_state, const HttpClientSettings &settings,
+                                          const HttpRequest &request, const std::string &key, bool read_cache,
+                                          bool write_cache) {
+    if (settings.cache_path.empty()) {
+        return SendHttpRequest(client_state, settings, request);
+    }
+    HttpResponse response;
+    if (read_cache && client_state.disk_cache.Lookup(settings, key, response)) {
+        GetHostMetrics(client_state, request).cache_hits.fetch_add(1, std::memory_order_relaxed);
+        return response;
+    }
+    response = SendHttpRequest(client_state, settings, request);
+    if (write_cache) {
+        client_state.disk_cache.Store(settings, key, response);
+    }
+    return response;
+}
+
+HttpResponse PerformHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                                const HttpRequest &request) {
+    if (request.method != "GET") {
+        return SendHttpRequest(client_state, settings, request);
+    }
+
+    // A request sending Cache-Control: no-cache skips the caches for this call, no-store also keeps the response out
+    bool read_cache = true;
+    bool write_cache = true;
+    auto cache_control = request.headers.find("Cache-Control");
+    if (cache_control != request.headers.end()) {
+        auto directives = StringUtil::Lower(cache_control->second);
+        write_cache = !StringUtil::Contains(directives, "no-store");
+        read_cache = write_cache && !StringUtil::Contains(directives, "no-cache");
+    }
+
+    auto &cache = client_state.response_cache;
+    auto key = HttpResponseCache::CacheKey(request);
+    if (settings.cache_size == 0 || !read_cache) {
+        auto response = FetchThroughDiskCache(client_state, settings, request, key, read_cache, write_cache);
+        if (write_cache) {
+            cache.Store(key, response, settings.cache_size);
+        }
+        return response;
+    }
+
+    auto lookup = cache.Lookup(key);
+    if (lookup.entry && lookup.fresh) {
+        GetHostMetrics(client_state, request).cache_hits.fetch_add(1, std::memory_order_relaxed);
+        return lookup.entry->response;
+    }
+    if (!lookup.entry || !lookup.entry->HasValidator()) {
+        auto response = FetchThroughDiskCache(client_state, settings, request, key, true, true);
+        cache.Store(key, response, settings.cache_size);
+        return response;
+    }
+
+    // Stale, ask the server whether our copy is still current; a 304 costs a round trip but no body
+    auto conditional = request;
+    HttpResponseCache::AddValidators(*lookup.entry, conditional.headers);
+    auto response = SendHttpRequest(client_state, settings, conditional);
+    if (response.received && response.status == 304) {
+        cache.RecordRevalidation(true);
+        cache.Refresh(key, response.headers);
+        auto cached = lookup.entry->response;
+        cached.elapsed_ms = response.elapsed_ms;
+        GetHostMetrics(client_state, request).cache_hits.fetch_add(1, std::memory_order_relaxed);
+        return cached;
+    }
+    cache.RecordRevalidation(false);
+    cache.Store(key, response, settings.cache_size);
+    if (!settings.cache_path.empty()) {
+        client_state.disk_cache.Store(settings, key, response);
+    }
+    return response;
+}
+
+bool HttpMethodTakesBody(const std::string &method) {
+    return method == "POST" || method == "PUT" || method == "PATCH";
+}
+
+bool HttpMethodShareable(const std::string &method, const HttpClientSettings &settings) {
+    return settings.deduplicate && (method == "GET" || method == "HEAD" || settings.deduplicate_writes);
+}
+
+void CheckHttpResponse(const HttpResponse &response, const std::string &request_type) {
+    if (!response.received) {
+        throw std::runtime_error(response.error);
+    }
+    // http_get and http_post have always insisted on 200, the other methods commonly answer 201 or 204
+    auto success = request_type == "GET" || request_type == "POST" ? response.status == 200
+                                                                   : response.status >= 200 && response.status < 300;
+    if (!success) {
+        throw std::runtime_error("HTTP " + request_type + " error: " + std::to_string(response.status) + " - " +
+                                 response.reason);
+    }
+}
+
+Value HttpHeadersToValue(const duckdb_httplib_openssl::Headers &headers) {
+    vector<Value> keys;
+    vector<Value> values;
+    // MAP keys must be unique; Headers orders keys case-insensitively, so repeated headers are adjacent.
+    // They are folded into one comma-separated value as RFC 9110 allows.
+    for (auto it = headers.begin(); it != headers.end();) {
+        auto range = headers.equal_range(it->first);
+        std::string value = it->second;
+        for (auto dup = std::next(range.first); dup != range.second; ++dup) {
+            value += ", " + dup->second;
+        }
+        keys.emplace_back(it->first);
+        values.emplace_back(std::move(value));
+        it = range.second;
+    }
+    return Value::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR, std::move(keys), std::move(values));
+}
+
+} // namespace duckdb
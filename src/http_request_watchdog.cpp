@@ -0,0 +1,61 @@
+#include "http_request_watchdog.hpp"
+
+#include <chrono>
+#include <system_error>
+
+namespace duckdb {
+
+//! How often the flags of watched requests are checked
+static constexpr std::chrono::milliseconds WATCH_INTERVAL(50);
+
+HttpRequestWatchdog::~HttpRequestWatchdog() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        shutdown = true;
+    }
+    changed.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void HttpRequestWatchdog::Watch(duckdb_httplib_openssl::Client &client, const std::atomic<bool> &interrupted) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!started) {
+        started = true;
+        try {
+            thread = std::thread([this]() { WatchLoop(); });
+        } catch (std::system_error &) {
+            // Without the thread an interrupt is noticed once the request returns (or times out)
+        }
+    }
+    watched[&client] = &interrupted;
+    changed.notify_one();
+}
+
+void HttpRequestWatchdog::Unwatch(duckdb_httplib_openssl::Client &client) {
+    std::lock_guard<std::mutex> guard(lock);
+    watched.erase(&client);
+}
+
+void HttpRequestWatchdog::WatchLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!shutdown) {
+        if (watched.empty()) {
+            changed.wait(guard, [&]() { return shutdown || !watched.empty(); });
+            continue;
+        }
+        changed.wait_for(guard, WATCH_INTERVAL);
+        // Stopping under the lock guarantees that Unwatch returns only once the client is left alone
+        for (auto it = watched.begin(); it != watched.end();) {
+            if (it->second->load()) {
+                it->first->stop();
+                it = watched.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+} // namespace duckdb
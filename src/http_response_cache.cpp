@@ -0,0 +1,216 @@
+#include "http_response_cache.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+namespace {
+
+struct CacheControl {
+    bool no_store = false;
+    bool no_cache = false;
+    bool has_max_age = false;
+    int64_t max_age = 0;
+};
+
+} // namespace
+
+static std::string GetHeader(const duckdb_httplib_openssl::Headers &headers, const std::string &name) {
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+static bool ParseSeconds(const std::string &value, int64_t &result) {
+    if (value.empty() || value.size() > 18 || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    result = std::stoll(value);
+    return true;
+}
+
+static CacheControl ParseCacheControl(const duckdb_httplib_openssl::Headers &headers) {
+    CacheControl result;
+    auto range = headers.equal_range("Cache-Control");
+    for (auto it = range.first; it != range.second; ++it) {
+        for (auto &directive : StringUtil::Split(StringUtil::Lower(it->second), ',')) {
+            StringUtil::Trim(directive);
+            if (directive == "no-store") {
+                result.no_store = true;
+            } else if (directive == "no-cache") {
+                result.no_cache = true;
+            } else if (StringUtil::StartsWith(directive, "max-age=")) {
+                auto value = directive.substr(8);
+                StringUtil::Trim(value);
+                result.has_max_age = ParseSeconds(value, result.max_age) || result.has_max_age;
+            }
+        }
+    }
+    return result;
+}
+
+// Seconds a response may be served without revalidation, max-age minus the time it already spent in other caches
+static int64_t FreshnessLifetime(const CacheControl &cache_control, const duckdb_httplib_openssl::Headers &headers) {
+    if (cache_control.no_cache || !cache_control.has_max_age) {
+        return 0;
+    }
+    int64_t age = 0;
+    ParseSeconds(GetHeader(headers, "Age"), age);
+    return MaxValue<int64_t>(cache_control.max_age - age, 0);
+}
+
+bool HttpResponseCache::StorableLifetime(const duckdb_httplib_openssl::Headers &headers, int64_t &lifetime) {
+    auto cache_control = ParseCacheControl(headers);
+    lifetime = FreshnessLifetime(cache_control, headers);
+    return !cache_control.no_store;
+}
+
+std::string HttpResponseCache::CacheKey(const HttpRequest &request) {
+    // Request headers are part of the key since they may change the response (we don't track Vary), except for
+    // Cache-Control which only decides whether the cache is used. Entries keep no request body to compare, so the
+    // body of a (rare) GET that has one is part of the key in full.
+    std::string key;
+    if (request.headers.find("Cache-Control") == request.headers.end()) {
+        key = request.Key();
+    } else {
+        auto uncached = request;
+        uncached.headers.erase("Cache-Control");
+        key = uncached.Key();
+    }
+    if (request.BodySize() > 0) {
+        key += "\n";
+        key.append(request.BodyData(), request.BodySize());
+    }
+    return key;
+}
+
+HttpCacheLookup HttpResponseCache::Lookup(const std::string &key) {
+    HttpCacheLookup result;
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return result;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    result.entry = it->second->response;
+    result.fresh = std::chrono::steady_clock::now() < result.entry->fresh_until;
+    if (result.fresh) {
+        hits++;
+    } else if (!result.entry->HasValidator()) {
+        // Stale and cannot be revalidated, it is fetched again like a missing entry
+        misses++;
+    }
+    return result;
+}
+
+void HttpResponseCache::Store(const std::string &key, const HttpResponse &response, idx_t max_size) {
+    if (max_size == 0 || !response.received || response.status != 200) {
+        return;
+    }
+    auto cache_control = ParseCacheControl(response.headers);
+    if (cache_control.no_store) {
+        return;
+    }
+
+    auto entry = make_shared_ptr<HttpCachedResponse>();
+    entry->etag = GetHeader(response.headers, "ETag");
+    entry->last_modified = GetHeader(response.headers, "Last-Modified");
+    auto lifetime = FreshnessLifetime(cache_control, response.headers);
+    if (lifetime == 0 && !entry->HasValidator()) {
+        // Could never be served: it is stale right away and cannot be revalidated
+        return;
+    }
+
+    entry->size = sizeof(HttpCachedResponse) + key.size() + response.reason.size() + response.body.size();
+    for (auto &header : response.headers) {
+        entry->size += header.first.size() + header.second.size();
+    }
+    if (entry->size > max_size) {
+        return;
+    }
+    entry->response = response;
+    entry->response.elapsed_ms = 0;
+    entry->fresh_until = std::chrono::steady_clock::now() + std::chrono::seconds(lifetime);
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        total_size -= it->second->response->size;
+        lru.erase(it->second);
+        entries.erase(it);
+    }
+    lru.push_front(Entry {key, std::move(entry)});
+    entries[key] = lru.begin();
+    total_size += lru.front().response->size;
+    EvictUntil(max_size);
+}
+
+void HttpResponseCache::Refresh(const std::string &key, const duckdb_httplib_openssl::Headers &headers) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return;
+    }
+    auto &entry = *it->second->response;
+    // A 304 may carry updated caching headers, otherwise those of the stored response still apply
+    auto cache_control = ParseCacheControl(headers);
+    auto source = &headers;
+    if (!cache_control.has_max_age && !cache_control.no_cache) {
+        source = &entry.response.headers;
+        cache_control = ParseCacheControl(*source);
+    }
+    entry.fresh_until =
+        std::chrono::steady_clock::now() + std::chrono::seconds(FreshnessLifetime(cache_control, *source));
+}
+
+void HttpResponseCache::AddValidators(const HttpCachedResponse &entry, duckdb_httplib_openssl::Headers &headers) {
+    if (!entry.etag.empty()) {
+        headers.emplace("If-None-Match", entry.etag);
+    }
+    if (!entry.last_modified.empty()) {
+        headers.emplace("If-Modified-Since", entry.last_modified);
+    }
+}
+
+void HttpResponseCache::RecordRevalidation(bool not_modified) {
+    if (not_modified) {
+        revalidations++;
+    } else {
+        misses++;
+    }
+}
+
+void HttpResponseCache::EvictUntil(idx_t max_size) {
+    while (total_size > max_size && !lru.empty()) {
+        auto &victim = lru.back();
+        total_size -= victim.response->size;
+        entries.erase(victim.key);
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+void HttpResponseCache::Shrink(idx_t max_size) {
+    std::lock_guard<std::mutex> guard(lock);
+    EvictUntil(max_size);
+}
+
+void HttpResponseCache::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    lru.clear();
+    total_size = 0;
+}
+
+HttpCacheStats HttpResponseCache::GetStats() {
+    HttpCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.revalidations = revalidations;
+    stats.evictions = evictions;
+    std::lock_guard<std::mutex> guard(lock);
+    stats.entries = entries.size();
+    stats.size = total_size;
+    return stats;
+}
+
+} // namespace duckdb
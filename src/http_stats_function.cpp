@@ -0,0 +1,80 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "http_client_state.hpp"
+#include "http_functions.hpp"
+
+namespace duckdb {
+
+struct HttpStatsBindData : public TableFunctionData {
+    bool reset = false;
+};
+
+struct HttpStatsState : public GlobalTableFunctionState {
+    vector<HttpHostMetricsSnapshot> hosts;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> HttpStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<HttpStatsBindData>();
+    for (auto &param : input.named_parameters) {
+        if (param.first == "reset" && !param.second.IsNull()) {
+            result->reset = BooleanValue::Get(param.second);
+        }
+    }
+
+    names = {"host",           "requests",       "failures",        "retries",         "cache_hits",
+             "connections_opened", "connections_reused", "bytes_sent", "bytes_received", "resolve_ms",
+             "ttfb_p50_ms",    "ttfb_p99_ms",    "transfer_p50_ms", "transfer_p99_ms", "latency_p50_ms",
+             "latency_p99_ms"};
+    return_types = {LogicalType::VARCHAR};
+    for (idx_t i = 1; i < 9; i++) {
+        return_types.push_back(LogicalType::UBIGINT);
+    }
+    for (idx_t i = 9; i < names.size(); i++) {
+        return_types.push_back(LogicalType::DOUBLE);
+    }
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> HttpStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<HttpStatsBindData>();
+    auto result = make_uniq<HttpStatsState>();
+    result->hosts = HttpClientState::Get(context)->metrics.Snapshot(bind_data.reset);
+    return std::move(result);
+}
+
+static void HttpStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<HttpStatsState>();
+    idx_t row = 0;
+    for (; state.offset < state.hosts.size() && row < STANDARD_VECTOR_SIZE; state.offset++, row++) {
+        auto &host = state.hosts[state.offset];
+        output.SetValue(0, row, Value(host.host));
+        output.SetValue(1, row, Value::UBIGINT(host.requests));
+        output.SetValue(2, row, Value::UBIGINT(host.failures));
+        output.SetValue(3, row, Value::UBIGINT(host.retries));
+        output.SetValue(4, row, Value::UBIGINT(host.cache_hits));
+        output.SetValue(5, row, Value::UBIGINT(host.connections_opened));
+        output.SetValue(6, row, Value::UBIGINT(host.connections_reused));
+        output.SetValue(7, row, Value::UBIGINT(host.bytes_sent));
+        output.SetValue(8, row, Value::UBIGINT(host.bytes_received));
+        output.SetValue(9, row, Value::DOUBLE(host.resolve_ms));
+        output.SetValue(10, row, Value::DOUBLE(host.ttfb_p50_ms));
+        output.SetValue(11, row, Value::DOUBLE(host.ttfb_p99_ms));
+        output.SetValue(12, row, Value::DOUBLE(host.transfer_p50_ms));
+        output.SetValue(13, row, Value::DOUBLE(host.transfer_p99_ms));
+        output.SetValue(14, row, Value::DOUBLE(host.latency_p50_ms));
+        output.SetValue(15, row, Value::DOUBLE(host.latency_p99_ms));
+    }
+    output.SetCardinality(row);
+}
+
+void HTTPFunctions::RegisterHTTPStatsFunction(DatabaseInstance &instance) {
+    TableFunction http_client_stats("http_client_stats", {}, HttpStatsFunction, HttpStatsBind, HttpStatsInit);
+    http_client_stats.named_parameters["reset"] = LogicalType::BOOLEAN;
+    ExtensionUtil::RegisterFunction(instance, http_client_stats);
+}
+
+} // namespace duckdb
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <mutex>
+#include <string>
+
+namespace duckdb {
+
+//! Recycles response body buffers in power-of-two size classes (4KB to 1MB), so that a steady stream of small
+//! responses reuses the same memory instead of going through malloc for every body. The idle buffers of all
+//! classes together take up at most http_client_buffer_pool_size bytes.
+class HttpBufferPool {
+public:
+    //! An empty buffer with room for at least size bytes, rounded up to its size class
+    std::string Take(idx_t size);
+    //! Hand back a buffer whose contents are no longer needed, it is kept while the pool holds less than max_bytes
+    void Give(std::string &&buffer, idx_t max_bytes);
+    //! Release idle buffers, the largest first, until at most max_bytes are left
+    void Shrink(idx_t max_bytes);
+
+private:
+    static constexpr idx_t MIN_CLASS_SIZE = 4 * 1024;
+    static constexpr idx_t CLASS_COUNT = 9;
+
+    static idx_t ClassSize(idx_t size_class) {
+        return MIN_CLASS_SIZE << size_class;
+    }
+
+    std::mutex lock;
+    vector<std::string> free_buffers[CLASS_COUNT];
+    idx_t pooled_bytes = 0;
+};
+
+} // namespace duckdb
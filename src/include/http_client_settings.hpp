@@ -0,0 +1,95 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Snapshot of the http_client_* settings, taken once per chunk so the per-row path never touches the config
+struct HttpClientSettings {
+    //! Whether connections are kept alive and handed back to the pool after a request
+    bool keep_alive = true;
+    //! Maximum number of connections (in use + idle) per (scheme, host, port)
+    idx_t max_connections_per_host = 8;
+    //! Whether the connections in use per host adapt (AIMD) to 429/5xx responses, errors and latency, up to
+    //! max_connections_per_host
+    bool adaptive_concurrency = false;
+    //! Seconds an idle pooled connection is kept before it is closed
+    idx_t pool_idle_timeout = 30;
+    //! Seconds between the requests that keep connections pinned by http_client_prewarm open, 0 disables them
+    idx_t heartbeat_interval = 15;
+    //! URLs whose hosts get a connection opened and pinned when the extension is loaded or the setting is set
+    vector<std::string> prewarm;
+    //! Seconds to wait for a connection to be established
+    double connect_timeout = 10;
+    //! Seconds to wait for data while reading a response
+    double read_timeout = 10;
+    //! Seconds to wait while sending a request
+    double write_timeout = 10;
+    //! Seconds a request may take overall, including its retries, 0 for no limit
+    double timeout = 0;
+    //! How often a request failing with a transient error or status is sent again
+    idx_t max_retries = 3;
+    //! Seconds before the first retry, doubled for every further one
+    double retry_backoff = 0.2;
+    //! Requests per second sent to one (scheme, host, port), 0 for no limit
+    double rate_limit = 0;
+    //! Maximum number of requests of one chunk that are in flight at the same time
+    idx_t max_concurrency = 32;
+    //! Maximum number of requests of one query in flight at the same time, across all threads running it, 0 for
+    //! no limit
+    idx_t query_concurrency = 0;
+    //! Number of I/O threads shared by all queries that requests are dispatched to
+    idx_t io_threads = 32;
+    //! Maximum bytes of GET responses kept in the in-memory response cache, 0 disables it
+    idx_t cache_size = 64 * 1024 * 1024;
+    //! Whether identical requests of a query share one network call
+    bool deduplicate = true;
+    //! Whether that also goes for methods with side effects (POST, PUT, PATCH, DELETE), not just GET and HEAD
+    bool deduplicate_writes = false;
+    //! Bytes of responses remembered per query so that repeated requests are not sent again
+    idx_t dedup_size = 64 * 1024 * 1024;
+    //! Bytes of idle response buffers kept for reuse, 0 allocates every body anew
+    idx_t buffer_pool_size = 16 * 1024 * 1024;
+    //! Concurrent Range requests a GET response larger than segment_size is downloaded with, 1 disables it
+    idx_t download_segments = 1;
+    //! Bytes fetched per Range request of a segmented download
+    idx_t segment_size = 8 * 1024 * 1024;
+    //! DuckDB's memory limit, a segmented download of a larger object is sent as a single stream instead
+    idx_t memory_limit = NumericLimits<idx_t>::Maximum();
+    //! Seconds a resolved host address is reused for new connections, 0 resolves every time
+    idx_t dns_cache_ttl = 60;
+    //! Fixed addresses for host names, they bypass the resolver
+    std::unordered_map<std::string, std::string> dns_overrides;
+    //! Whether gzip/deflate compressed responses are asked for, they are decompressed as they arrive
+    bool compression = true;
+    //! Whether request bodies are sent gzip compressed
+    bool compress_requests = false;
+    //! Rows http_post_batch sends per request at most
+    idx_t batch_rows = 1000;
+    //! Bytes of body http_post_batch sends per request at most (a single larger row is sent on its own)
+    idx_t batch_size = 1024 * 1024;
+    //! How http_post_batch joins rows: "ndjson" (one per line) or "json" (an array)
+    std::string batch_format = "ndjson";
+    //! Bytes of one line read_http_lines accepts at most, a longer one fails the scan
+    idx_t max_line_size = 64 * 1024 * 1024;
+    //! URL that relative request URLs are resolved against, empty when there is none
+    std::string base_url;
+    //! Directory of the persistent response cache, empty disables it
+    std::string cache_path;
+    //! Maximum bytes kept in cache_path
+    idx_t disk_cache_size = 1024 * 1024 * 1024;
+    //! Seconds a response in cache_path stays valid, 0 keeps it until it is evicted
+    idx_t disk_cache_ttl = 0;
+
+    //! Not a setting: requests in flight are aborted once this is set (the query's interrupt flag by default)
+    const std::atomic<bool> *interrupted = nullptr;
+
+    static void Register(DatabaseInstance &instance);
+    static HttpClientSettings Get(ClientContext &context);
+};
+
+} // namespace duckdb
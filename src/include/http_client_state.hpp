@@ -0,0 +1,42 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "http_buffer_pool.hpp"
+#include "http_connection_pool.hpp"
+#include "http_disk_cache.hpp"
+#include "http_executor.hpp"
+#include "http_metrics.hpp"
+#include "http_rate_limiter.hpp"
+#include "http_request_watchdog.hpp"
+#include "http_response_cache.hpp"
+
+namespace duckdb {
+
+//! Extension state owned by the DatabaseInstance (kept in its ObjectCache) and shared by all connections
+class HttpClientState : public ObjectCacheEntry {
+public:
+    static constexpr const char *CACHE_KEY = "http_client_state";
+
+    static std::string ObjectType() {
+        return "http_client_state";
+    }
+    std::string GetObjectType() override {
+        return ObjectType();
+    }
+
+    static shared_ptr<HttpClientState> Get(ClientContext &context);
+    static shared_ptr<HttpClientState> Get(DatabaseInstance &instance);
+
+    HttpConnectionPool pool;
+    HttpResponseCache response_cache;
+    HttpDiskCache disk_cache;
+    HttpRateLimiter rate_limiter;
+    HttpMetrics metrics;
+    HttpBufferPool buffers;
+    HttpRequestWatchdog watchdog;
+    //! Declared last so its threads are joined before the pool they use is destroyed
+    HttpExecutor executor;
+};
+
+} // namespace duckdb
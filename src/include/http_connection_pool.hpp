@@ -0,0 +1,236 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_client_settings.hpp"
+#include "http_dns_cache.hpp"
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#include "httplib.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace duckdb {
+
+struct HttpHostMetrics;
+
+//! The (scheme, host, port) triple connections are pooled by
+struct HttpEndpoint {
+    std::string scheme;
+    std::string host;
+    int port = 80;
+    //! Metrics of the endpoint when HttpUrlResolver looked them up along with it, so that requests record into
+    //! them without a lookup of their own
+    HttpHostMetrics *metrics = nullptr;
+
+    bool IsSSL() const {
+        return scheme == "https";
+    }
+    //! "scheme://host:port", used both as the pool key and to construct the client
+    std::string ToString() const;
+};
+
+//! A URL split into the endpoint to connect to and the request target (path + query)
+struct HttpUrl {
+    HttpEndpoint endpoint;
+    std::string path;
+
+    static HttpUrl Parse(const std::string &url);
+    //! The request target of url, which starts at start (the end of its authority)
+    static std::string ParseTarget(const std::string &url, idx_t start);
+};
+
+class HttpConnectionPool;
+
+//! State of the connections to one host, exposed through http_client_hosts()
+struct HttpHostStats {
+    std::string host;
+    idx_t active = 0;
+    idx_t idle = 0;
+    //! Connections that may be in use at the same time right now
+    idx_t limit = 0;
+    //! Smoothed latency of requests to the host
+    double latency_ms = 0;
+    idx_t successes = 0;
+    //! Requests answered with 429/5xx or failing with a transport error
+    idx_t overloads = 0;
+    //! Connections http_client_prewarm keeps open
+    idx_t pinned = 0;
+};
+
+//! A client leased from the pool; it is handed back when the lease goes out of scope
+class HttpConnection {
+public:
+    HttpConnection(HttpConnectionPool &pool, std::string key, unique_ptr<duckdb_httplib_openssl::Client> client);
+    HttpConnection(HttpConnection &&other) noexcept;
+    HttpConnection(const HttpConnection &) = delete;
+    HttpConnection &operator=(const HttpConnection &) = delete;
+    ~HttpConnection();
+
+    duckdb_httplib_openssl::Client &operator*() {
+        return *client;
+    }
+    duckdb_httplib_openssl::Client *operator->() {
+        return client.get();
+    }
+
+    //! Close the connection instead of returning it to the pool after a transport error. Only an error connecting
+    //! (httplib reports a connect timeout as one too) moves new connections to the host's next address; a cancelled
+    //! transfer, a read or write timeout or a closed keep-alive connection say nothing about the address.
+    void Invalidate(duckdb_httplib_openssl::Error error) {
+        reusable = false;
+        connect_failed = error == duckdb_httplib_openssl::Error::Connection ||
+                         error == duckdb_httplib_openssl::Error::SSLConnection;
+    }
+    //! Feed the outcome of a request into the host's adaptive concurrency limit
+    void ReportOutcome(bool overloaded, double latency_ms);
+
+    //! "scheme://host:port" of the connection
+    const std::string &Key() const {
+        return key;
+    }
+    //! Whether an open idle connection was leased, rather than one still to be established
+    bool Reused() const {
+        return reused;
+    }
+    //! Time spent resolving the host for this lease
+    double ResolveMilliseconds() const {
+        return resolve_ms;
+    }
+
+private:
+    friend class HttpConnectionPool;
+
+    optional_ptr<HttpConnectionPool> pool;
+    std::string key;
+    unique_ptr<duckdb_httplib_openssl::Client> client;
+    bool reusable = true;
+    bool connect_failed = false;
+    bool reused = false;
+    double resolve_ms = 0;
+    //! Address the connection goes to, empty when the client resolved the host itself
+    std::string address;
+};
+
+//! Keep-alive connections shared by all rows, chunks and queries of a database instance
+class HttpConnectionPool {
+public:
+    HttpConnectionPool() = default;
+    HttpConnectionPool(const HttpConnectionPool &) = delete;
+    HttpConnectionPool &operator=(const HttpConnectionPool &) = delete;
+    ~HttpConnectionPool();
+
+    //! Lease a connection to the endpoint, blocking while max_connections_per_host are in use. Throws once the pool
+    //! is shutting down.
+    HttpConnection Acquire(const HttpEndpoint &endpoint, const HttpClientSettings &settings);
+    //! Open connections to the endpoint until `connections` are established and keep that many pinned: they are
+    //! exempt from the idle timeout and pinged every heartbeat_interval. At most as many as the host's current
+    //! connection limit are pinned, and only slots that are free right now are used, 0 unpins the host. Returns
+    //! the number of established connections, error describes the last one that could not be opened.
+    idx_t Prewarm(const HttpEndpoint &endpoint, const HttpClientSettings &settings, idx_t connections,
+                  std::string &error);
+    //! Close all idle connections and forget the resolved addresses
+    void Clear();
+    vector<HttpHostStats> GetHostStats();
+
+private:
+    friend class HttpConnection;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleConnection {
+        unique_ptr<duckdb_httplib_openssl::Client> client;
+        Clock::time_point idle_since;
+        std::string address;
+    };
+
+    struct HostPool {
+        std::deque<IdleConnection> idle;
+        //! Clients whose connection was closed. A new connection is opened through one of them before a client
+        //! is constructed, which keeps its TLS context with the CA certificates already loaded.
+        vector<unique_ptr<duckdb_httplib_openssl::Client>> closed;
+        //! Number of connections currently leased out
+        idx_t active = 0;
+        //! Host name the connections go to
+        std::string host;
+        //! Settings of the most recent lease, applied when the connection comes back
+        bool keep_alive = true;
+        idx_t idle_timeout = 30;
+        idx_t max_connections = 8;
+        //! Adaptive limit on active connections (AIMD), only enforced with http_client_adaptive_concurrency
+        bool adaptive = false;
+        double limit = 0;
+        Clock::time_point last_decrease;
+        double latency_ms = 0;
+        idx_t successes = 0;
+        idx_t overloads = 0;
+        //! Idle connections kept regardless of the idle timeout, along with what the heartbeat reopens them with
+        idx_t pinned = 0;
+        HttpEndpoint endpoint;
+        HttpClientSettings pin_settings;
+
+        //! Connections that may be active at the same time
+        idx_t ActiveLimit() const {
+            return adaptive ? MinValue<idx_t>(MaxValue<idx_t>(static_cast<idx_t>(limit), 1), max_connections)
+                            : max_connections;
+        }
+        //! Take over the settings of a lease
+        void Configure(const HttpEndpoint &endpoint, const HttpClientSettings &settings);
+    };
+
+    //! A slot of a host taken by Reserve, along with the idle connection or closed client it reuses, if any
+    struct Reservation {
+        unique_ptr<duckdb_httplib_openssl::Client> client;
+        std::string address;
+        bool connected = false;
+    };
+
+    using EvictedConnection = std::pair<std::string, unique_ptr<duckdb_httplib_openssl::Client>>;
+
+    //! Take a slot of the host, waiting while it has none free unless wait is false. Returns false (wait = false)
+    //! or throws (wait = true) once the pool is shutting down, and false without a free slot.
+    bool Reserve(const std::string &key, const HttpEndpoint &endpoint, const HttpClientSettings &settings, bool wait,
+                 Reservation &reservation);
+    //! Turn a reservation into a lease, resolving and configuring its client
+    HttpConnection Lease(std::string key, const HttpEndpoint &endpoint, const HttpClientSettings &settings,
+                         Reservation reservation);
+
+    void Release(const std::string &key, unique_ptr<duckdb_httplib_openssl::Client> client, bool reusable,
+                 bool connect_failed, std::string address);
+    void RecordOutcome(const std::string &key, bool overloaded, double latency_ms);
+    //! Move connections idle for longer than their host's timeout into evicted (closed outside the lock)
+    void EvictIdle(Clock::time_point now, vector<EvictedConnection> &evicted);
+    //! Close the connections and keep their clients for later connections to the same host
+    void KeepClosed(vector<EvictedConnection> &evicted);
+    //! Lease up to `connections` connections at once, as long as the host has slots free, and send each a request,
+    //! which opens the ones not open yet
+    idx_t OpenConnections(const HttpEndpoint &endpoint, const HttpClientSettings &settings, idx_t connections,
+                          std::string &error);
+    bool Ping(HttpConnection &connection, std::string &error);
+    //! Keeps the connections of pinned hosts open, as long as the pool exists once a host was pinned
+    void HeartbeatLoop();
+
+    std::mutex lock;
+    std::condition_variable released;
+    std::unordered_map<std::string, HostPool> hosts;
+    //! Addresses new connections are opened to
+    HttpDnsCache dns;
+
+    std::condition_variable heartbeat_changed;
+    std::thread heartbeat;
+    bool heartbeat_started = false;
+    //! Seconds between heartbeats, as set by the most recent Prewarm
+    idx_t heartbeat_interval = 0;
+    //! Clients a ping is in flight on, they are stopped when the pool is destroyed
+    std::unordered_set<duckdb_httplib_openssl::Client *> pinging;
+    bool shutdown = false;
+};
+
+} // namespace duckdb
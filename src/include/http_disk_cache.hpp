@@ -0,0 +1,75 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "http_client_settings.hpp"
+#include "http_message.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+struct HttpDiskCacheStats {
+    idx_t hits = 0;
+    idx_t misses = 0;
+    idx_t entries = 0;
+    idx_t size = 0;
+};
+
+//! Persistent cache of GET responses in http_client_cache_path. Responses are appended to segment files, an
+//! in-memory index (request digest -> location) is rebuilt from the segments when the directory is opened, and
+//! whole segments are dropped oldest-first once the directory exceeds http_client_disk_cache_size.
+//! Requests are only stored as a SHA-256 digest of their key, so their headers and bodies (credentials, API keys)
+//! never end up on disk. The directory is meant to be used by one process at a time.
+class HttpDiskCache {
+public:
+    //! Returns true and fills response if an entry for key exists that is still fresh per its Cache-Control and
+    //! within http_client_disk_cache_ttl
+    bool Lookup(const HttpClientSettings &settings, const std::string &key, HttpResponse &response);
+    //! Append a 200 response that may be served for a while without revalidation (max-age, no no-store/no-cache)
+    void Store(const HttpClientSettings &settings, const std::string &key, const HttpResponse &response);
+    HttpDiskCacheStats GetStats();
+
+private:
+    struct Segment {
+        idx_t id = 0;
+        std::string path;
+        unique_ptr<FileHandle> handle;
+        idx_t size = 0;
+    };
+
+    struct Location {
+        shared_ptr<Segment> segment;
+        idx_t offset;
+        idx_t length;
+        int64_t stored_at;
+        //! Unix time until which the response is fresh
+        int64_t expires_at;
+    };
+
+    //! Switch to the directory in settings (if it changed) and make the cache fit its size limit, under lock
+    void Configure(const HttpClientSettings &settings);
+    //! Index the records of segment, a segment written in an older format is emptied
+    void ScanSegment(const shared_ptr<Segment> &segment);
+    shared_ptr<Segment> OpenSegment(idx_t id, bool create);
+    //! Drop the oldest segments until the cache fits in max_size, under lock
+    void EvictUntil(idx_t max_size);
+
+    std::mutex lock;
+    unique_ptr<FileSystem> fs;
+    std::string directory;
+    //! By id, so the oldest segment comes first
+    std::map<idx_t, shared_ptr<Segment>> segments;
+    //! By the digest of the request key
+    std::unordered_map<std::string, Location> index;
+    idx_t total_size = 0;
+
+    std::atomic<idx_t> hits {0};
+    std::atomic<idx_t> misses {0};
+};
+
+} // namespace duckdb
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_client_settings.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Host name to address cache shared by all connections of the pool, so that opening a connection does not
+//! go through the system resolver every time. All resolved addresses are kept: new connections go to the
+//! preferred one until it fails, then to the next, as a resolving client would (e.g. IPv4 after a broken IPv6
+//! route).
+class HttpDnsCache {
+public:
+    //! The numeric address to connect to for host, empty to let the client resolve it (IP literals, failures)
+    std::string Resolve(const std::string &host, const HttpClientSettings &settings);
+    //! A connection to address failed: move on to the next address of host, and resolve host again once each of
+    //! them failed
+    void Failed(const std::string &host, const std::string &address);
+    void Clear();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        //! In the resolver's (RFC 6724) preference order
+        vector<std::string> addresses;
+        //! Index of the address new connections go to
+        idx_t current = 0;
+        //! Addresses that failed since host was resolved
+        idx_t failures = 0;
+        Clock::time_point expires;
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+} // namespace duckdb
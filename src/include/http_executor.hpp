@@ -0,0 +1,49 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace duckdb {
+
+//! Fixed set of I/O threads, owned by the database instance, that all http_* calls dispatch their requests to.
+//! Threads are started on first use and live until the database is closed, so no thread is spawned per chunk.
+class HttpExecutor {
+public:
+    HttpExecutor() = default;
+    HttpExecutor(const HttpExecutor &) = delete;
+    HttpExecutor &operator=(const HttpExecutor &) = delete;
+    ~HttpExecutor();
+
+    //! Run task(i) for every i in [0, count) with up to max_concurrency in flight (bounded by io_threads + the
+    //! calling thread); blocks until all are done and rethrows the first failure
+    void Run(idx_t count, idx_t max_concurrency, idx_t io_threads, const std::function<void(idx_t)> &task);
+
+    //! Start worker threads until there are at least thread_count, returns the number running
+    idx_t EnsureThreads(idx_t thread_count);
+    //! Queue a job for the I/O threads without waiting for it, the job must not outlive the data it references
+    void Submit(std::function<void()> job, const void *owner = nullptr);
+    //! Take the jobs of owner that no I/O thread has started yet off the queue, returns how many there were
+    idx_t Withdraw(const void *owner);
+
+private:
+    struct Job {
+        std::function<void()> run;
+        //! Who submitted the job, so that it can be withdrawn
+        const void *owner;
+    };
+
+    void WorkerLoop();
+
+    std::mutex lock;
+    std::condition_variable job_available;
+    std::deque<Job> jobs;
+    vector<std::thread> threads;
+    bool shutdown = false;
+};
+
+} // namespace duckdb
@@ -6,13 +6,34 @@ namespace duckdb {
 
 struct HTTPFunctions {
 public:
-	static void Register(DatabaseInstance &db) {
-		RegisterHTTPRequestFunction(db);
-	}
+    static void Register(DatabaseInstance &db) {
+        RegisterHTTPRequestFunction(db);
+        RegisterHTTPBatchFunction(db);
+        RegisterHTTPCopyFunction(db);
+        RegisterHTTPFetchFunction(db);
+        RegisterHTTPLinesFunction(db);
+        RegisterHTTPCacheFunctions(db);
+        RegisterHTTPPoolFunctions(db);
+        RegisterHTTPStatsFunction(db);
+    }
 
 private:
-	//! Register HTTPRequest functions
-	static void RegisterHTTPRequestFunction(DatabaseInstance &db);
+    //! Register HTTPRequest functions
+    static void RegisterHTTPRequestFunction(DatabaseInstance &db);
+    //! Register the http_post_batch aggregate
+    static void RegisterHTTPBatchFunction(DatabaseInstance &db);
+    //! Register the COPY TO http function
+    static void RegisterHTTPCopyFunction(DatabaseInstance &db);
+    //! Register the http_fetch table function
+    static void RegisterHTTPFetchFunction(DatabaseInstance &db);
+    //! Register the read_http_lines table function
+    static void RegisterHTTPLinesFunction(DatabaseInstance &db);
+    //! Register the response cache inspection functions
+    static void RegisterHTTPCacheFunctions(DatabaseInstance &db);
+    //! Register the connection pool inspection and warm-up functions
+    static void RegisterHTTPPoolFunctions(DatabaseInstance &db);
+    //! Register the http_client_stats table function
+    static void RegisterHTTPStatsFunction(DatabaseInstance &db);
 };
 
 } // namespace duckdb
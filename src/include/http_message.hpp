@@ -0,0 +1,69 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "http_connection_pool.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace duckdb {
+
+//! A request as issued by one row of an http_* function
+struct HttpRequest {
+    //! Upper case method, e.g. "GET", "POST" or "HEAD"
+    std::string method = "GET";
+    std::string url;
+    duckdb_httplib_openssl::Headers headers;
+    std::string body;
+    //! The body when it is borrowed from the caller (e.g. a row of the input vector) rather than owned in body;
+    //! it has to stay valid until the request is done
+    const char *body_data = nullptr;
+    idx_t body_size = 0;
+    //! Produces the body piece by piece instead, it is then sent with chunked transfer encoding
+    duckdb_httplib_openssl::ContentProviderWithoutLength body_provider;
+    std::string content_type = "application/json";
+    //! The url split up front (see HttpUrlResolver), otherwise it is parsed when the request is sent
+    shared_ptr<const HttpEndpoint> endpoint;
+    std::string target;
+
+    const char *BodyData() const {
+        return body_data ? body_data : body.data();
+    }
+    idx_t BodySize() const {
+        return body_data ? body_size : body.size();
+    }
+
+    //! Identifies requests that are bound to get the same response: method, url, headers and the length and hash of
+    //! the body. A large body is not copied into every key, so requests with one key still need SameBody.
+    std::string Key() const {
+        auto key = method + " " + url;
+        for (auto &header : headers) {
+            key += "\n" + header.first + ": " + header.second;
+        }
+        if (BodySize() > 0) {
+            key += "\n\n" + std::to_string(BodySize()) + " " + std::to_string(Hash(BodyData(), BodySize()));
+        }
+        return key;
+    }
+    //! Whether the bodies are the same, for requests whose keys are
+    bool SameBody(const char *data, idx_t size) const {
+        return BodySize() == size && (size == 0 || memcmp(BodyData(), data, size) == 0);
+    }
+};
+
+//! Outcome of a request. A transport failure is not thrown but reported through received/error, so that the
+//! caller decides whether it fails the query
+struct HttpResponse {
+    bool received = false;
+    int32_t status = 0;
+    std::string reason;
+    duckdb_httplib_openssl::Headers headers;
+    std::string body;
+    double elapsed_ms = 0;
+    //! Why no response was received
+    std::string error;
+    duckdb_httplib_openssl::Error transport_error = duckdb_httplib_openssl::Error::Success;
+};
+
+} // namespace duckdb
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Latency histogram with power-of-two millisecond buckets, recorded with relaxed atomics
+class HttpLatencyHistogram {
+public:
+    //! Bucket 0 holds everything below 1/16 ms, bucket i up to 2^(i-4) ms, the last one everything above
+    static constexpr idx_t BUCKET_COUNT = 24;
+
+    void Record(double milliseconds);
+    //! Upper bound of the bucket the q-th quantile falls into, 0 when nothing was recorded
+    double Quantile(double q) const;
+    idx_t Count() const;
+    void Reset();
+
+private:
+    std::atomic<idx_t> buckets[BUCKET_COUNT] {};
+};
+
+//! Counters of the requests sent to one (scheme, host, port)
+struct HttpHostMetrics {
+    std::atomic<idx_t> requests {0};
+    //! Attempts that got no response at all
+    std::atomic<idx_t> failures {0};
+    std::atomic<idx_t> retries {0};
+    std::atomic<idx_t> cache_hits {0};
+    std::atomic<idx_t> connections_opened {0};
+    std::atomic<idx_t> connections_reused {0};
+    std::atomic<idx_t> bytes_sent {0};
+    std::atomic<idx_t> bytes_received {0};
+    //! Microseconds spent resolving the host for new connections
+    std::atomic<idx_t> resolve_us {0};
+    //! Request sent until the response headers arrived: connect, TLS handshake and server time included
+    HttpLatencyHistogram time_to_first_byte;
+    //! Response headers until the end of the body
+    HttpLatencyHistogram transfer;
+    //! Whole attempts
+    HttpLatencyHistogram latency;
+};
+
+//! A row of http_client_stats()
+struct HttpHostMetricsSnapshot {
+    std::string host;
+    idx_t requests = 0;
+    idx_t failures = 0;
+    idx_t retries = 0;
+    idx_t cache_hits = 0;
+    idx_t connections_opened = 0;
+    idx_t connections_reused = 0;
+    idx_t bytes_sent = 0;
+    idx_t bytes_received = 0;
+    double resolve_ms = 0;
+    double ttfb_p50_ms = 0;
+    double ttfb_p99_ms = 0;
+    double transfer_p50_ms = 0;
+    double transfer_p99_ms = 0;
+    double latency_p50_ms = 0;
+    double latency_p99_ms = 0;
+};
+
+//! Request metrics of all hosts. Looking up a host takes a lock, so HttpUrlResolver does it once per endpoint and
+//! requests only record into the lock-free counters of their endpoint.
+class HttpMetrics {
+public:
+    HttpHostMetrics &ForHost(const std::string &host);
+    //! Read all counters, optionally starting them over
+    vector<HttpHostMetricsSnapshot> Snapshot(bool reset);
+
+private:
+    std::mutex lock;
+    //! Entries are never removed, so references handed out stay valid
+    std::unordered_map<std::string, unique_ptr<HttpHostMetrics>> hosts;
+};
+
+} // namespace duckdb
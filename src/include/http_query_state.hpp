@@ -0,0 +1,114 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "http_client_settings.hpp"
+#include "http_message.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Single-flight de-duplication: identical requests that are in flight at the same time wait for the first one,
+//! and responses are remembered (up to a byte budget) so repeats later in the query are not sent again
+class HttpRequestDeduplicator {
+public:
+    //! Share the response of the request in flight or remembered for key (request's HttpRequest::Key), or perform
+    //! it. A request whose body differs from that one only collides with its key and is performed on its own.
+    //! Throws InterruptException when interrupted is raised while waiting for another thread's identical request.
+    shared_ptr<HttpResponse> Perform(const std::string &key, const HttpRequest &request, idx_t memo_budget,
+                                     const std::atomic<bool> *interrupted,
+                                     const std::function<HttpResponse()> &perform);
+    void Clear();
+
+private:
+    struct Flight {
+        std::mutex lock;
+        std::condition_variable completed;
+        //! Set before the flight is published, the key only carries a hash of it
+        std::string body;
+        bool done = false;
+        shared_ptr<HttpResponse> response;
+        std::exception_ptr error;
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, shared_ptr<Flight>> flights;
+    //! Bytes of the completed responses kept in flights
+    idx_t memo_size = 0;
+};
+
+//! Caps the requests of one query in flight across all DuckDB threads executing it. Slots are granted in the order
+//! they were asked for, so a thread with a large backlog cannot starve the others of the query.
+class HttpRequestScheduler {
+public:
+    //! Wait for a slot while fewer than limit are taken (0 = no limit); returns false when interrupted first
+    bool Acquire(idx_t limit, const std::atomic<bool> *interrupted);
+    void Release();
+
+private:
+    std::mutex lock;
+    std::condition_variable released;
+    idx_t in_flight = 0;
+    //! Tickets of the waiting requests in arrival order
+    std::deque<uint64_t> waiting;
+    uint64_t next_ticket = 0;
+};
+
+//! A slot of an HttpRequestScheduler, held for the lifetime of the object
+class HttpSchedulerSlot {
+public:
+    HttpSchedulerSlot(HttpRequestScheduler &scheduler, idx_t limit, const std::atomic<bool> *interrupted)
+        : scheduler(scheduler), acquired(false), granted(true) {
+        if (limit > 0) {
+            acquired = granted = scheduler.Acquire(limit, interrupted);
+        }
+    }
+    ~HttpSchedulerSlot() {
+        if (acquired) {
+            scheduler.Release();
+        }
+    }
+    HttpSchedulerSlot(const HttpSchedulerSlot &) = delete;
+    HttpSchedulerSlot &operator=(const HttpSchedulerSlot &) = delete;
+
+    //! False when the wait for the slot was interrupted
+    bool Granted() const {
+        return granted;
+    }
+
+private:
+    HttpRequestScheduler &scheduler;
+    bool acquired;
+    bool granted;
+};
+
+//! State of the current query in a ClientContext, reset when the query ends
+class HttpQueryState : public ClientContextState {
+public:
+    static constexpr const char *STATE_KEY = "http_client_query_state";
+
+    static shared_ptr<HttpQueryState> Get(ClientContext &context);
+
+    void QueryEnd(ClientContext &context) override;
+
+    //! The settings of the context as the query started running, read the first time they are asked for. Callbacks
+    //! without a bind or init step of their own per run (aggregates) take them from here rather than bind data.
+    HttpClientSettings Settings(ClientContext &context);
+
+    HttpRequestDeduplicator deduplicator;
+    HttpRequestScheduler scheduler;
+
+private:
+    std::mutex settings_lock;
+    unique_ptr<HttpClientSettings> settings;
+};
+
+} // namespace duckdb
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Sleep until the deadline in short slices, returning false as soon as interrupted (may be null) is raised
+bool InterruptibleSleepUntil(std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *interrupted);
+
+//! Token bucket per (scheme, host, port) spacing out requests to at most a given rate, with bursts of up to one
+//! second's worth of requests
+class HttpRateLimiter {
+public:
+    //! Block until a request to the host may be sent at rate requests per second (0 = unlimited). Returns false
+    //! when interrupted is raised first, after handing the reserved token back to the bucket
+    bool Wait(const std::string &host, double rate, const std::atomic<bool> *interrupted);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+        //! Negative while requests are waiting for their token
+        double tokens = 0;
+        Clock::time_point updated;
+        bool initialized = false;
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, Bucket> buckets;
+};
+
+} // namespace duckdb
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_client_settings.hpp"
+#include "http_client_state.hpp"
+#include "http_message.hpp"
+
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace duckdb {
+
+//! Parse the URL (unless the request was resolved already) and lease a pooled client for its host, returns the
+//! client and the request target
+std::pair<HttpConnection, std::string> SetupHttpClient(HttpClientState &client_state,
+                                                       const HttpClientSettings &settings, const HttpRequest &request);
+
+//! Splits the URLs of many requests up front, resolving relative ones against http_client_base_url. URLs on the
+//! same scheme://host:port as the previous one share its parsed endpoint, so only their target is split off.
+class HttpUrlResolver {
+public:
+    //! With metrics, every endpoint carries its host's metrics (looked up once per endpoint, not per request)
+    explicit HttpUrlResolver(const HttpClientSettings &settings, HttpMetrics *metrics = nullptr);
+
+    //! Make request.url absolute and fill in request.endpoint and request.target
+    void Resolve(HttpRequest &request);
+
+private:
+    //! Base URL without trailing slashes, empty when there is none
+    std::string base_url;
+    HttpMetrics *metrics;
+    //! "scheme://host:port" part of the previous URL and its parsed endpoint
+    std::string last_authority;
+    shared_ptr<const HttpEndpoint> last_endpoint;
+};
+
+//! The distinct endpoints of urls, in order, relative ones resolved against http_client_base_url
+vector<HttpEndpoint> HttpEndpointsOf(const HttpClientSettings &settings, const vector<std::string> &urls);
+//! Open and pin `connections` connections to the host of every url on the I/O threads, without waiting for them
+void PrewarmHttpHosts(HttpClientState &client_state, HttpClientSettings settings, const vector<std::string> &urls,
+                      idx_t connections);
+
+//! Describe why a request did not produce a response
+std::string HttpErrorMessage(const duckdb_httplib_openssl::Result &res, const std::string &request_type);
+std::string HttpErrorMessage(duckdb_httplib_openssl::Error error, const std::string &request_type);
+//! Throw a descriptive error for a request that did not produce a response
+void HandleHttpError(const duckdb_httplib_openssl::Result &res, const std::string &request_type);
+
+//! Send a request over a pooled connection to its host, GET requests are answered from the response cache when
+//! possible
+HttpResponse PerformHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                                const HttpRequest &request);
+//! Called with the final response's status and headers before its body arrives, returning false aborts it
+using HttpResponseHandler = std::function<bool(const duckdb_httplib_openssl::Response &)>;
+//! Called with each piece of the body as it arrives, returning false aborts the transfer
+using HttpContentReceiver = std::function<bool(const char *data, idx_t length)>;
+
+//! Send a request over a pooled connection without any caching and hand its body to content_receiver as it
+//! arrives; the returned response has no body. An aborted transfer is reported as not received.
+HttpResponse StreamHttpRequest(HttpClientState &client_state, const HttpClientSettings &settings,
+                               const HttpRequest &request, const HttpResponseHandler &response_handler,
+                               const HttpContentReceiver &content_receiver);
+//! Throw unless a successful response was received: status 200 for GET and POST as http_get and http_post
+//! require, any 2xx status for the other methods
+void CheckHttpResponse(const HttpResponse &response, const std::string &request_type);
+//! Whether requests of this method carry a body (and a Content-Type) even when it is empty
+bool HttpMethodTakesBody(const std::string &method);
+//! Whether identical requests of this method may share one response: GET and HEAD, plus POST, PUT, PATCH and
+//! DELETE with http_client_deduplicate_writes
+bool HttpMethodShareable(const std::string &method, const HttpClientSettings &settings);
+
+//! Parse "Key: Value" lines into request headers
+duckdb_httplib_openssl::Headers ParseHttpHeaders(const char *data, idx_t length);
+duckdb_httplib_openssl::Headers ParseHttpHeaders(const std::string &headers);
+//! Convert a headers argument, "Key: Value" lines or a MAP, into request headers
+duckdb_httplib_openssl::Headers HttpHeadersFromValue(const Value &headers);
+
+//! The MAP(VARCHAR, VARCHAR) type response headers are returned as
+inline LogicalType HttpHeadersType() {
+    return LogicalType::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR);
+}
+
+//! Convert response headers to a MAP value, repeated headers are joined with ", "
+Value HttpHeadersToValue(const duckdb_httplib_openssl::Headers &headers);
+
+} // namespace duckdb
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_connection_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! Aborts requests in flight once their interrupt flag is raised. httplib blocks in connect and read until a
+//! timeout expires, so a watcher thread stops the sockets of interrupted requests from the outside.
+class HttpRequestWatchdog {
+public:
+    HttpRequestWatchdog() = default;
+    HttpRequestWatchdog(const HttpRequestWatchdog &) = delete;
+    HttpRequestWatchdog &operator=(const HttpRequestWatchdog &) = delete;
+    ~HttpRequestWatchdog();
+
+    //! Stop client as soon as interrupted is set, until Unwatch
+    void Watch(duckdb_httplib_openssl::Client &client, const std::atomic<bool> &interrupted);
+    //! Once this returns the client is no longer touched, so it can go back to the pool
+    void Unwatch(duckdb_httplib_openssl::Client &client);
+
+private:
+    void WatchLoop();
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::unordered_map<duckdb_httplib_openssl::Client *, const std::atomic<bool> *> watched;
+    std::thread thread;
+    bool started = false;
+    bool shutdown = false;
+};
+
+//! Watches a client for the duration of one request
+class HttpWatchedRequest {
+public:
+    HttpWatchedRequest(HttpRequestWatchdog &watchdog, duckdb_httplib_openssl::Client &client,
+                       const std::atomic<bool> *interrupted)
+        : watchdog(watchdog), client(client), active(interrupted != nullptr) {
+        if (active) {
+            watchdog.Watch(client, *interrupted);
+        }
+    }
+    HttpWatchedRequest(const HttpWatchedRequest &) = delete;
+    HttpWatchedRequest &operator=(const HttpWatchedRequest &) = delete;
+    ~HttpWatchedRequest() {
+        if (active) {
+            watchdog.Unwatch(client);
+        }
+    }
+
+private:
+    HttpRequestWatchdog &watchdog;
+    duckdb_httplib_openssl::Client &client;
+    bool active;
+};
+
+} // namespace duckdb
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "http_message.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! A stored GET response. The response itself is immutable once stored, only its freshness is extended when it
+//! is revalidated (guarded by the cache lock).
+struct HttpCachedResponse {
+    HttpResponse response;
+    std::string etag;
+    std::string last_modified;
+    std::chrono::steady_clock::time_point fresh_until;
+    //! Bytes accounted against http_client_cache_size
+    idx_t size = 0;
+
+    bool HasValidator() const {
+        return !etag.empty() || !last_modified.empty();
+    }
+};
+
+struct HttpCacheLookup {
+    //! nullptr on a miss
+    shared_ptr<HttpCachedResponse> entry;
+    //! Whether the entry can be served without revalidation
+    bool fresh = false;
+};
+
+//! Counters exposed through http_client_cache_stats()
+struct HttpCacheStats {
+    idx_t hits = 0;
+    idx_t misses = 0;
+    idx_t revalidations = 0;
+    idx_t evictions = 0;
+    idx_t entries = 0;
+    idx_t size = 0;
+};
+
+//! Memory-bounded LRU cache of GET responses, honoring Cache-Control max-age/no-store/no-cache and revalidating
+//! stale entries through their ETag/Last-Modified
+class HttpResponseCache {
+public:
+    static std::string CacheKey(const HttpRequest &request);
+
+    //! Counts a hit for a fresh entry and a miss for none or a stale one without validators, a stale entry that
+    //! can be revalidated is counted by RecordRevalidation
+    HttpCacheLookup Lookup(const std::string &key);
+    //! Store a 200 response if its headers allow it, evicting least recently used entries above max_size
+    void Store(const std::string &key, const HttpResponse &response, idx_t max_size);
+    //! A revalidation returned 304 Not Modified, the entry is fresh again per the headers of that response
+    void Refresh(const std::string &key, const duckdb_httplib_openssl::Headers &headers);
+    //! Seconds a response may be served without revalidation per its Cache-Control (max-age, no-cache) and Age
+    //! headers; false when Cache-Control: no-store forbids keeping it at all
+    static bool StorableLifetime(const duckdb_httplib_openssl::Headers &headers, int64_t &lifetime);
+    //! Add the conditional request headers for revalidating entry
+    static void AddValidators(const HttpCachedResponse &entry, duckdb_httplib_openssl::Headers &headers);
+
+    //! Evict entries until the cache fits in max_size bytes
+    void Shrink(idx_t max_size);
+    void Clear();
+    HttpCacheStats GetStats();
+
+    //! Count the outcome of revalidating a stale entry: a 304 or a full miss
+    void RecordRevalidation(bool not_modified);
+
+private:
+    struct Entry {
+        std::string key;
+        shared_ptr<HttpCachedResponse> response;
+    };
+
+    void EvictUntil(idx_t max_size);
+
+    std::mutex lock;
+    //! Most recently used at the front
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    idx_t total_size = 0;
+
+    std::atomic<idx_t> hits {0};
+    std::atomic<idx_t> misses {0};
+    std::atomic<idx_t> revalidations {0};
+    std::atomic<idx_t> evictions {0};
+};
+
+} // namespace duckdb
@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Runs the tests that need the local mock server (test/sql/http_mock.test) instead of a public service, so that
+# timing, retry and connection assertions do not depend on its latency or availability. Then checks that
+# interrupting a query (SIGINT to the CLI, like Ctrl-C) ends requests, retry backoffs and rate limit waits promptly.
+#
+#   BUILD_BENCHMARK=1 make release
+#   test/run_mock_tests.sh [unittest arguments ...]      (default: test/sql/http_mock.test)
+#
+# Environment: BUILD (build/release), PORT (8089)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+BUILD=${BUILD:-build/release}
+PORT=${PORT:-8089}
+ARGS=("$@")
+if [ ${#ARGS[@]} -eq 0 ]; then
+    ARGS=(test/sql/http_mock.test)
+fi
+
+UNITTEST="$BUILD/test/unittest"
+DUCKDB="$BUILD/duckdb"
+SERVER="$BUILD/extension/http_client/http_mock_server"
+for binary in "$UNITTEST" "$DUCKDB" "$SERVER"; do
+    if [ ! -x "$binary" ]; then
+        echo "$binary not found, build with: BUILD_BENCHMARK=1 make release" >&2
+        exit 1
+    fi
+done
+
+WORK=$(mktemp -d)
+SERVER_PID=
+cleanup() {
+    if [ -n "$SERVER_PID" ]; then
+        kill "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+    fi
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+"$SERVER" --port "$PORT" 2>"$WORK/server.log" &
+SERVER_PID=$!
+for _ in $(seq 50); do
+    if grep -q listening "$WORK/server.log"; then
+        break
+    fi
+    sleep 0.1
+done
+sleep 0.2
+if ! kill -0 "$SERVER_PID" 2>/dev/null; then
+    cat "$WORK/server.log" >&2
+    exit 1
+fi
+
+URL="http://127.0.0.1:$PORT"
+HTTP_MOCK_SERVER="$URL" "$UNITTEST" "${ARGS[@]}"
+
+# The query would block for 30 seconds or more, after an interrupt it has to be done within 3
+interrupted() {
+    local name=$1 sql=$2 pid start elapsed
+    "$DUCKDB" -unsigned -c "$sql" >"$WORK/interrupt.log" 2>&1 &
+    pid=$!
+    sleep 1
+    start=$(date +%s.%N)
+    kill -INT "$pid"
+    wait "$pid" || true
+    elapsed=$(awk -v start="$start" -v end="$(date +%s.%N)" 'BEGIN { printf "%.1f", end - start }')
+    if ! grep -q Interrupt "$WORK/interrupt.log" || awk -v e="$elapsed" 'BEGIN { exit !(e > 3) }'; then
+        echo "interrupting $name took ${elapsed}s:" >&2
+        cat "$WORK/interrupt.log" >&2
+        exit 1
+    fi
+    echo "interrupting $name took ${elapsed}s"
+}
+interrupted "a request in flight" "SELECT http_get('$URL/delay/30?x=' || i) FROM range(4) t(i);"
+interrupted "a retry backoff" \
+    "SET http_client_retry_backoff = 30; SELECT (http_get_ex('$URL/status/503?x=' || i)).status FROM range(4) t(i);"
+interrupted "a Retry-After wait" "SELECT (http_get_ex('$URL/retry-after/30?x=' || i)).status FROM range(4) t(i);"
+interrupted "a rate limit wait" \
+    "SET http_client_rate_limit = 0.01; SELECT (http_get_ex('$URL/get?x=' || i)).status FROM range(4) t(i);"